@@ -0,0 +1,109 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "AptDetector.hpp"
+#include <cmath>
+
+// a pure sine gives 1, a square wave 8/pi^2
+const double AptDetector::threshold=0.4;
+
+AptDetector::AptDetector(void)
+	: blockLength(1), count(0), mean(128), sum(0), sumSquares(0),
+	  blockTime(0), tone(0), level(0), blocks(0)
+{
+}
+
+void AptDetector::init(int sampleRate, const std::vector<int>& frequencies)
+{
+	tones=frequencies;
+	coeff.resize(tones.size());
+	for(size_t i=0; i<tones.size(); i++) {
+		coeff[i]=2*std::cos(2*M_PI*tones[i]/sampleRate);
+	}
+	s1.assign(tones.size(),0);
+	s2.assign(tones.size(),0);
+	blockLength=sampleRate/25;
+	if(blockLength<1) {
+		blockLength=1;
+	}
+	blockTime=static_cast<double>(blockLength)/sampleRate;
+	count=0;
+	mean=128;
+	sum=sumSquares=0;
+	tone=blocks=0;
+	level=0;
+}
+
+// The mean of the last block is taken off, so the black/white level does
+// not leak into the tones.
+
+bool AptDetector::process(int x)
+{
+	double v=x-mean;
+	sum+=v;
+	sumSquares+=v*v;
+	for(size_t i=0; i<tones.size(); i++) {
+		double s=v+coeff[i]*s1[i]-s2[i];
+		s2[i]=s1[i];
+		s1[i]=s;
+	}
+	if(++count<blockLength) {
+		return false;
+	}
+
+	// power of the block without its mean, a sine of amplitude a gives
+	// n*a^2/2 here and (n*a/2)^2 in the Goertzel power
+	double n=blockLength;
+	double power=sumSquares-sum*sum/n;
+	int best=0;
+	double bestLevel=0;
+	for(size_t i=0; i<tones.size(); i++) {
+		double p=s1[i]*s1[i]+s2[i]*s2[i]-coeff[i]*s1[i]*s2[i];
+		double l=power>0 ? p/(n*power/2) : 0;
+		if(l>bestLevel) {
+			bestLevel=l;
+			best=tones[i];
+		}
+		s1[i]=s2[i]=0;
+	}
+	level=bestLevel>1 ? 1 : bestLevel;
+	if(level<threshold) {
+		best=0;
+	}
+	blocks=best==tone ? blocks+1 : 1;
+	tone=best;
+	mean+=sum/n;
+	count=0;
+	sum=sumSquares=0;
+	return true;
+}
+
+int AptDetector::frequency(void) const
+{
+	return tone;
+}
+
+double AptDetector::confidence(void) const
+{
+	return level;
+}
+
+double AptDetector::duration(void) const
+{
+	return tone==0 ? 0 : blocks*blockTime;
+}
@@ -0,0 +1,85 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef APTDETECTOR_HPP
+#define APTDETECTOR_HPP
+
+#include <vector>
+
+/**
+ * Finds the APT tones in the demodulated signal.
+ *
+ * The signal is cut into blocks of 40ms. For every block and every tone
+ * frequency, the Goertzel algorithm gives the power of that frequency.
+ * The share of the power of the block (without its mean) that falls into
+ * the strongest frequency is the confidence, it is about 0.8 for a clean
+ * black/white pattern and low for noise or image content. This costs a
+ * few multiplications per sample and tone.
+ */
+
+class AptDetector {
+public:
+	AptDetector(void);
+
+	/**
+	 * Start over.
+	 *
+	 * \param sampleRate is the rate of the demodulated signal
+	 * \param frequencies are the tones to look for in Hz
+	 */
+	void init(int sampleRate, const std::vector<int>& frequencies);
+
+	/**
+	 * Take the next sample.
+	 *
+	 * \return true if a block is complete and the results are new
+	 */
+	bool process(int x);
+
+	/**
+	 * The tone found in the last block, 0 if there was none.
+	 */
+	int frequency(void) const;
+
+	/**
+	 * Confidence of the last block, from 0 to 1.
+	 */
+	double confidence(void) const;
+
+	/**
+	 * Seconds the tone of frequency() has been there without a break.
+	 */
+	double duration(void) const;
+private:
+	static const double threshold;
+	std::vector<int> tones;
+	std::vector<double> coeff;
+	std::vector<double> s1;
+	std::vector<double> s2;
+	int blockLength;
+	int count;
+	double mean;
+	double sum;
+	double sumSquares;
+	double blockTime;
+	int tone;
+	double level;
+	int blocks;
+};
+
+#endif
@@ -0,0 +1,92 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "BatchDecoder.hpp"
+#include "Error.hpp"
+#include "FaxDecoder.hpp"
+#include <QRunnable>
+
+// Each task only writes to its own job, so no locking is needed. The
+// decoder is created in the worker thread and lives there until the file
+// is done.
+
+class BatchTask : public QRunnable {
+public:
+	BatchTask(BatchDecoder::Job* job)
+		: job(job)
+	{
+	}
+
+	void run(void)
+	{
+		try {
+			FaxDecoder decoder(0);
+			decoder.decodeFile(job->input,job->parameters);
+			job->audioTime=decoder.audioTime();
+			job->speed=decoder.speed();
+			if(!decoder.save(job->output)) {
+				throw Error(QString("could not save %1")
+					    .arg(job->output));
+			}
+			job->ok=true;
+		} catch(Error e) {
+			job->error=e.getText();
+		}
+	}
+private:
+	BatchDecoder::Job* job;
+};
+
+BatchDecoder::BatchDecoder(int threads)
+{
+	if(threads>0) {
+		pool.setMaxThreadCount(threads);
+	}
+}
+
+void BatchDecoder::add(const QString& input, const QString& output,
+		       const FaxParameters& p)
+{
+	Job job;
+	job.input=input;
+	job.output=output;
+	job.parameters=p;
+	job.ok=false;
+	job.audioTime=job.speed=0;
+	jobList.append(job);
+}
+
+int BatchDecoder::run(void)
+{
+	for(int i=0; i<jobList.size(); i++) {
+		pool.start(new BatchTask(&jobList[i]));
+	}
+	pool.waitForDone();
+	int failed=0;
+	for(int i=0; i<jobList.size(); i++) {
+		if(!jobList[i].ok) {
+			failed++;
+		}
+	}
+	return failed;
+}
+
+const QVector<BatchDecoder::Job>& BatchDecoder::jobs(void) const
+{
+	return jobList;
+}
@@ -0,0 +1,78 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef BATCHDECODER_HPP
+#define BATCHDECODER_HPP
+
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include "FaxParameters.hpp"
+
+/**
+ * Decodes many audio files at once. Every file gets a FaxDecoder of its
+ * own that runs in a thread of a QThreadPool, so the files are spread
+ * over all cores. The decoders take their settings from the job and do
+ * not look into the configuration.
+ */
+
+class BatchDecoder {
+public:
+	/**
+	 * One file to decode and, after run(), the outcome.
+	 */
+	struct Job {
+		QString input;
+		QString output;
+		FaxParameters parameters;
+		bool ok;
+		QString error;
+		double audioTime;
+		double speed;
+	};
+
+	/**
+	 * \param threads is the number of files decoded at the same time,
+	 * 0 for one per core
+	 */
+	BatchDecoder(int threads=0);
+
+	/**
+	 * Add a file.
+	 *
+	 * \param input is the audio file
+	 * \param output is the image file, its format is taken from the name
+	 * \param p holds the settings for this file
+	 */
+	void add(const QString& input, const QString& output,
+		 const FaxParameters& p);
+
+	/**
+	 * Decode all files and wait until they are done.
+	 *
+	 * \return the number of files that could not be decoded
+	 */
+	int run(void);
+
+	const QVector<Job>& jobs(void) const;
+private:
+	QThreadPool pool;
+	QVector<Job> jobList;
+};
+
+#endif
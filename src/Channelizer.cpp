@@ -0,0 +1,75 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "Channelizer.hpp"
+
+Channelizer::Channelizer(RingBuffer<short>* input, int channels)
+	: QObject(0), input(input), rings(channels), block(blockSize)
+{
+	for(int i=0; i<channels; i++) {
+		rings[i]=new RingBuffer<short>;
+	}
+	timer=new QTimer(this);
+	connect(timer,SIGNAL(timeout()),SLOT(distribute()));
+	moveToThread(&thread);
+	thread.start();
+}
+
+Channelizer::~Channelizer(void)
+{
+	thread.quit();
+	thread.wait();
+	for(size_t i=0; i<rings.size(); i++) {
+		delete rings[i];
+	}
+}
+
+RingBuffer<short>* Channelizer::channel(int i)
+{
+	return rings[i];
+}
+
+int Channelizer::channels(void) const
+{
+	return rings.size();
+}
+
+// The pipelines do not read yet, so the buffers may be reset here.
+
+void Channelizer::start(int sampleRate)
+{
+	for(size_t i=0; i<rings.size(); i++) {
+		rings[i]->reset(2*sampleRate);
+	}
+	timer->start(10);
+}
+
+void Channelizer::stop(void)
+{
+	timer->stop();
+}
+
+void Channelizer::distribute(void)
+{
+	size_t n;
+	while((n=input->read(&block[0],blockSize))>0) {
+		for(size_t i=0; i<rings.size(); i++) {
+			rings[i]->write(&block[0],n);
+		}
+	}
+}
@@ -0,0 +1,85 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef CHANNELIZER_HPP
+#define CHANNELIZER_HPP
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <vector>
+#include "RingBuffer.hpp"
+
+/**
+ * Hands the samples of one sound card to several receive chains, e.g. for
+ * a receiver whose audio passband holds several facsimile signals at
+ * different audio frequencies.
+ *
+ * A thread of its own takes the samples out of the capture ring buffer
+ * every 10 ms and copies them into one ring buffer per channel. Each
+ * channel is read by a ReceptionPipeline in its own thread, whose
+ * FaxDemodulator mixes its carrier down and decimates, so the channels
+ * are demodulated in parallel on separate cores. A channel that falls
+ * behind loses samples in its own ring buffer only.
+ */
+
+class Channelizer : public QObject {
+	Q_OBJECT
+public:
+	/**
+	 * \param input is the capture ring buffer, the channelizer becomes
+	 * its only reader
+	 * \param channels is the number of channels
+	 */
+	Channelizer(RingBuffer<short>* input, int channels);
+	~Channelizer(void);
+
+	/**
+	 * The ring buffer of channel i, for ReceptionPipeline::setSource().
+	 */
+	RingBuffer<short>* channel(int i);
+
+	/**
+	 * Number of channels.
+	 */
+	int channels(void) const;
+public slots:
+	/**
+	 * Start copying. Use Qt::BlockingQueuedConnection.
+	 *
+	 * \param sampleRate gives the size of the channel buffers, two
+	 * seconds each
+	 */
+	void start(int sampleRate);
+
+	/**
+	 * Stop copying. Use Qt::BlockingQueuedConnection.
+	 */
+	void stop(void);
+private slots:
+	void distribute(void);
+private:
+	static const int blockSize=4096;
+	QThread thread;
+	QTimer* timer;
+	RingBuffer<short>* input;
+	std::vector<RingBuffer<short>*> rings;
+	std::vector<short> block;
+};
+
+#endif
@@ -42,14 +42,21 @@ Config::Config()
 	setDefault("/hamfax/APT/startFrequency",300);
 	setDefault("/hamfax/APT/stopLength",5);
 	setDefault("/hamfax/APT/stopFrequency",450);
+	setDefault("/hamfax/APT/dwell",250);
 	setDefault("/hamfax/modulation/carrier",1900);
 	setDefault("/hamfax/modulation/deviation",400);
 	setDefault("/hamfax/modulation/filter",1);
 	setDefault("/hamfax/modulation/FM",true);
+	setDefault("/hamfax/modulation/decimation",0);
+	setDefault("/hamfax/modulation/discriminator",1);
+	setDefault("/hamfax/modulation/fixedPoint",false);
 	setDefault("/hamfax/fax/color",false);
 	setDefault("/hamfax/fax/LPM",120);
 	setDefault("/hamfax/phasing/lines",20);
 	setDefault("/hamfax/phasing/invert",false);
+	setDefault("/hamfax/receiver/memoryLimit",0);
+	setDefault("/hamfax/receiver/kernel",0);
+	setDefault("/hamfax/receiver/slantTracking",true);
 	setDefault("/hamfax/directories/qm", PKGDATADIR);
 	setDefault("/hamfax/directories/doc",PKGDATADIR);
 	setDefault("/hamfax/GUI/toolTips",true);
@@ -87,6 +94,32 @@ void Config::writeEntry(const QString& key, int value)
 	setValue(key, value);
 }
 
+FaxParameters Config::faxParameters(void)
+{
+	FaxParameters p;
+	p.carrier=readNumEntry("/hamfax/modulation/carrier");
+	p.deviation=readNumEntry("/hamfax/modulation/deviation");
+	p.filter=readNumEntry("/hamfax/modulation/filter");
+	p.fm=readBoolEntry("/hamfax/modulation/FM");
+	p.decimation=readNumEntry("/hamfax/modulation/decimation");
+	p.fastDiscriminator=
+		readNumEntry("/hamfax/modulation/discriminator")==1;
+	p.fixedPoint=readBoolEntry("/hamfax/modulation/fixedPoint");
+	p.lpm=readNumEntry("/hamfax/fax/LPM");
+	p.color=readBoolEntry("/hamfax/fax/color");
+	p.aptStartFrequency=readNumEntry("/hamfax/APT/startFrequency");
+	p.aptStartLength=readNumEntry("/hamfax/APT/startLength");
+	p.aptStopFrequency=readNumEntry("/hamfax/APT/stopFrequency");
+	p.aptStopLength=readNumEntry("/hamfax/APT/stopLength");
+	p.aptDwell=readNumEntry("/hamfax/APT/dwell");
+	p.phasingLines=readNumEntry("/hamfax/phasing/lines");
+	p.phaseInvert=readBoolEntry("/hamfax/phasing/invert");
+	p.memoryLimit=readNumEntry("/hamfax/receiver/memoryLimit");
+	p.kernel=readNumEntry("/hamfax/receiver/kernel");
+	p.slantTracking=readBoolEntry("/hamfax/receiver/slantTracking");
+	return p;
+}
+
 void Config::setDefault(const QString& key, const char* v)
 {
 	setValue(key,value(key,(const QString)v));
@@ -22,6 +22,7 @@
 #include <memory>
 #include <qsettings.h>
 #include <qstring.h>
+#include "FaxParameters.hpp"
 
 /**
  * This class is implemented as a Singleton and provides a global interface to 
@@ -44,6 +45,12 @@ public:
 	void writeEntry(const QString& key, const QString& value);
 	void writeEntry(const QString& key, bool value);
 	void writeEntry(const QString& key, int value);
+
+	/**
+	 * The current fax settings in one piece, for handing them to the
+	 * engines.
+	 */
+	FaxParameters faxParameters(void);
 private:
 	typedef std::auto_ptr<Config> ConfigPtr;
 	friend class std::auto_ptr<Config>;
@@ -0,0 +1,166 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "FaxDaemon.hpp"
+#include "FaxDecoder.hpp"
+#include "TimeStamp.hpp"
+#include <cstdio>
+
+FaxDaemon::FaxDaemon(const QString& outputDir, const FaxParameters& p,
+		     QObject* parent)
+	: QObject(parent), outputDir(outputDir), ring(0), sampleRate(0),
+	  defaults(p), entry(-1),
+	  receiving(false), image(false), sessions(false), maxMinutes(30)
+{
+	decoder=new FaxDecoder(this);
+	connect(decoder,SIGNAL(receptionStarts()),SLOT(receptionStarts()));
+	connect(decoder,SIGNAL(imageStarts()),SLOT(imageStarts()));
+	connect(decoder,SIGNAL(received()),SLOT(received()));
+	scheduleTimer=new QTimer(this);
+	connect(scheduleTimer,SIGNAL(timeout()),SLOT(checkSchedule()));
+	limitTimer=new QTimer(this);
+	limitTimer->setSingleShot(true);
+	connect(limitTimer,SIGNAL(timeout()),SLOT(timeout()));
+}
+
+void FaxDaemon::addSchedule(const QTime& begin, const QTime& end,
+			    const QString& name, const FaxParameters& p)
+{
+	Entry e;
+	e.begin=begin;
+	e.end=end;
+	e.name=name;
+	e.parameters=p;
+	schedule.append(e);
+}
+
+void FaxDaemon::setSource(RingBuffer<short>* ring, int sampleRate)
+{
+	this->ring=ring;
+	this->sampleRate=sampleRate;
+}
+
+void FaxDaemon::setPrefix(const QString& prefix)
+{
+	this->prefix=prefix;
+}
+
+void FaxDaemon::setSessions(bool b)
+{
+	sessions=b;
+}
+
+void FaxDaemon::setMaxMinutes(int m)
+{
+	maxMinutes=m;
+}
+
+void FaxDaemon::start(void)
+{
+	entry=activeEntry();
+	if(ring) {
+		decoder->startRing(ring,sampleRate,parameters(),true);
+	} else {
+		decoder->startSound(parameters(),true);
+	}
+	scheduleTimer->start(30000);
+}
+
+int FaxDaemon::activeEntry(void) const
+{
+	QTime now=QDateTime::currentDateTimeUtc().time();
+	for(int i=0; i<schedule.size(); i++) {
+		const Entry& e=schedule[i];
+		if(e.begin<=e.end ? now>=e.begin && now<e.end
+		   : now>=e.begin || now<e.end) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+const FaxParameters& FaxDaemon::parameters(void) const
+{
+	return entry<0 ? defaults : schedule[entry].parameters;
+}
+
+void FaxDaemon::receptionStarts(void)
+{
+	receiving=true;
+	image=false;
+	limitTimer->start(maxMinutes*60000);
+}
+
+void FaxDaemon::imageStarts(void)
+{
+	image=true;
+	imageTime=QDateTime::currentDateTimeUtc();
+}
+
+// The receiver may report the end more than once while the stop tone
+// lasts, only the first one counts.
+
+void FaxDaemon::received(void)
+{
+	if(!receiving) {
+		return;
+	}
+	receiving=false;
+	limitTimer->stop();
+	if(image) {
+		QString name=timeStampName(imageTime,"");
+		if(entry>=0) {
+			name=schedule[entry].name+"-"+name;
+		}
+		if(!prefix.isEmpty()) {
+			name=prefix+"-"+name;
+		}
+		name=outputDir.filePath(name);
+		if(decoder->save(name+".png")) {
+			std::fprintf(stderr,"hamfax-cli: saved %s.png\n",
+				     name.toLocal8Bit().constData());
+		} else {
+			std::fprintf(stderr,"hamfax-cli: could not save %s.png\n",
+				     name.toLocal8Bit().constData());
+		}
+		if(sessions) {
+			decoder->saveSession(name+".hfs");
+		}
+	}
+	entry=activeEntry();
+	decoder->restartSound(parameters());
+}
+
+void FaxDaemon::checkSchedule(void)
+{
+	int e=activeEntry();
+	if(e!=entry && !receiving) {
+		entry=e;
+		decoder->restartSound(parameters());
+		std::fprintf(stderr,"hamfax-cli: now receiving %s\n",
+			     e<0 ? "without schedule" :
+			     schedule[e].name.toLocal8Bit().constData());
+	}
+}
+
+void FaxDaemon::timeout(void)
+{
+	std::fprintf(stderr,"hamfax-cli: reception takes longer than %d "
+		     "minutes, ending it\n",maxMinutes);
+	decoder->endReception();
+}
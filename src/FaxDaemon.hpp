@@ -0,0 +1,134 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef FAXDAEMON_HPP
+#define FAXDAEMON_HPP
+
+#include <QDateTime>
+#include <QDir>
+#include <QObject>
+#include <QString>
+#include <QTime>
+#include <QTimer>
+#include <QVector>
+#include "FaxParameters.hpp"
+#include "RingBuffer.hpp"
+
+class FaxDecoder;
+
+/**
+ * Unattended reception from the sound device. After every facsimile the
+ * image is saved with a time stamp in its name and the receiver waits for
+ * the next APT start tone, without closing the sound device.
+ *
+ * A schedule gives other settings and a name for the images between two
+ * times of the day (UTC), e.g. for the broadcasts of different stations.
+ * The schedule is looked at every 30 seconds while no facsimile is
+ * received. A reception that does not end by itself is ended after the
+ * longest reception time.
+ *
+ * Nothing grows from one facsimile to the next: the image is replaced and
+ * the receiver keeps the memory of its samples for the next one, so the
+ * daemon can run for weeks.
+ */
+
+class FaxDaemon : public QObject {
+	Q_OBJECT
+public:
+	/**
+	 * \param outputDir is the directory for the images
+	 * \param p holds the settings outside of the schedule
+	 * \param parent is the parent object
+	 */
+	FaxDaemon(const QString& outputDir, const FaxParameters& p,
+		  QObject* parent);
+
+	/**
+	 * Add a schedule entry, the first entry that matches counts.
+	 *
+	 * \param begin is the start of the entry (UTC)
+	 * \param end is the end of the entry (UTC), it may be before begin
+	 * for entries over midnight
+	 * \param name is put in front of the names of the images
+	 * \param p holds the settings
+	 */
+	void addSchedule(const QTime& begin, const QTime& end,
+			 const QString& name, const FaxParameters& p);
+
+	/**
+	 * Take the samples from a ring buffer instead of the sound device.
+	 *
+	 * \param ring is read by the daemon only
+	 * \param sampleRate is the rate of the samples
+	 */
+	void setSource(RingBuffer<short>* ring, int sampleRate);
+
+	/**
+	 * Put prefix in front of the names of the images, e.g. to tell the
+	 * channels apart.
+	 */
+	void setPrefix(const QString& prefix);
+
+	/**
+	 * Also save a session file for every image.
+	 */
+	void setSessions(bool b);
+
+	/**
+	 * Longest time from the APT start tone to the end of a reception.
+	 */
+	void setMaxMinutes(int m);
+
+	/**
+	 * Open the sound device, or take the ring buffer, and start
+	 * receiving.
+	 */
+	void start(void);
+private slots:
+	void receptionStarts(void);
+	void imageStarts(void);
+	void received(void);
+	void checkSchedule(void);
+	void timeout(void);
+private:
+	struct Entry {
+		QTime begin;
+		QTime end;
+		QString name;
+		FaxParameters parameters;
+	};
+	int activeEntry(void) const;
+	const FaxParameters& parameters(void) const;
+	QDir outputDir;
+	QString prefix;
+	RingBuffer<short>* ring;
+	int sampleRate;
+	FaxParameters defaults;
+	QVector<Entry> schedule;
+	int entry;          // schedule entry in use, -1 for none
+	bool receiving;     // between the APT start tone and the end
+	bool image;         // the phasing is over, there is an image
+	QDateTime imageTime;
+	bool sessions;
+	int maxMinutes;
+	FaxDecoder* decoder;
+	QTimer* scheduleTimer;
+	QTimer* limitTimer;
+};
+
+#endif
@@ -0,0 +1,279 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "FaxDecoder.hpp"
+#include "FaxDemodulator.hpp"
+#include "FaxReceiver.hpp"
+#include "File.hpp"
+#include "ReceptionPipeline.hpp"
+#include "Sound.hpp"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <vector>
+
+FaxDecoder::FaxDecoder(QObject* parent)
+	: QObject(parent), demod(0), rx(0), pipeline(0), file(0), sound(0),
+	  stopRequest(0), done(false), continuous(false), soundRate(0),
+	  seconds(0), elapsed(0)
+{
+}
+
+FaxDecoder::~FaxDecoder(void)
+{
+	delete pipeline;
+}
+
+void FaxDecoder::connectReceiver(FaxReceiver* rx)
+{
+	connect(rx,SIGNAL(scanLines(const ScanLines&)),
+		SLOT(setScanLines(const ScanLines&)));
+	connect(rx,SIGNAL(newSize(int,int,int,int)),
+		SLOT(resize(int,int,int,int)));
+	connect(rx,SIGNAL(end()),SLOT(end()));
+	connect(rx,SIGNAL(startingPhasing()),SIGNAL(receptionStarts()));
+	connect(rx,SIGNAL(imageStarts()),SIGNAL(imageStarts()));
+}
+
+void FaxDecoder::createImage(int width)
+{
+	image=QImage(width,50,QImage::Format_RGB32);
+	image.fill(qRgb(80,80,80));
+}
+
+// Everything lives in the calling thread, so the receiver's signals are
+// delivered directly while the loop runs.
+
+void FaxDecoder::createEngines(void)
+{
+	if(!file) {
+		file=new File(this);
+		demod=new FaxDemodulator(this);
+		rx=new FaxReceiver(this);
+		connect(demod,SIGNAL(data(int*,int)),rx,SLOT(decode(int*,int)));
+		connectReceiver(rx);
+	}
+}
+
+void FaxDecoder::decodeFile(const QString& fileName, const FaxParameters& p)
+{
+	createEngines();
+	int sampleRate=file->startInput(fileName);
+	startBatch(sampleRate,p);
+
+	std::vector<short> buffer(batchSize);
+	qint64 samples=0;
+	QElapsedTimer timer;
+	timer.start();
+	while(!done && !stopRequest.loadAcquire()) {
+		int n=file->read(&buffer[0],batchSize);
+		// an empty block makes the receiver finish the image
+		demod->newSamples(&buffer[0],n);
+		samples+=n;
+	}
+	elapsed=timer.nsecsElapsed()/1e9;
+	seconds=static_cast<double>(samples)/sampleRate;
+	file->end();
+}
+
+void FaxDecoder::decodeSamples(const short* samples, size_t n,
+			       int sampleRate, const FaxParameters& p)
+{
+	createEngines();
+	startBatch(sampleRate,p);
+
+	size_t pos=0;
+	QElapsedTimer timer;
+	timer.start();
+	while(!done && !stopRequest.loadAcquire()) {
+		int m=std::min<size_t>(n-pos,batchSize);
+		demod->newSamples(const_cast<short*>(samples+pos),m);
+		pos+=m;
+	}
+	elapsed=timer.nsecsElapsed()/1e9;
+	seconds=static_cast<double>(pos)/sampleRate;
+}
+
+void FaxDecoder::startBatch(int sampleRate, const FaxParameters& p)
+{
+	createImage(p.width());
+	rx->setWidth(p.width());
+	rx->init(demod->init(sampleRate,p),p);
+	stopRequest.storeRelease(0);
+	done=false;
+}
+
+bool FaxDecoder::saveSession(const QString& fileName)
+{
+	if(pipeline) {
+		bool ok=false;
+		QMetaObject::invokeMethod(pipeline->receiver(),"saveSession",
+					  Qt::BlockingQueuedConnection,
+					  Q_RETURN_ARG(bool,ok),
+					  Q_ARG(QString,fileName));
+		return ok;
+	}
+	return rx && rx->saveSession(fileName);
+}
+
+bool FaxDecoder::renderSession(const QString& fileName, double lpm, int width,
+			       int kernel)
+{
+	FaxSession header;
+	if(!header.open(fileName)) {
+		return false;
+	}
+	if(width==0) {
+		width=header.width;
+	}
+	header.close();
+	createEngines();
+	if(!rx->loadSession(fileName)) {
+		return false;
+	}
+	rx->setWidth(width);
+	rx->setKernel(kernel);
+	createImage(width);
+	rx->redraw(lpm);
+	return true;
+}
+
+void FaxDecoder::startSound(const FaxParameters& p, bool continuous)
+{
+	sound=new Sound(this);
+	int sampleRate=sound->startInput();
+	startRing(&sound->captureBuffer(),sampleRate,p,continuous);
+}
+
+void FaxDecoder::startRing(RingBuffer<short>* ring, int sampleRate,
+			   const FaxParameters& p, bool continuous)
+{
+	this->continuous=continuous;
+	soundRate=sampleRate;
+	pipeline=new ReceptionPipeline;
+	connectReceiver(pipeline->receiver());
+	pipeline->setSource(ring);
+	pipeline->setParameters(p);
+	createImage(p.width());
+	QMetaObject::invokeMethod(pipeline->receiver(),"setWidth",
+				  Qt::BlockingQueuedConnection,
+				  Q_ARG(int,p.width()));
+	QMetaObject::invokeMethod(pipeline,"start",
+				  Qt::BlockingQueuedConnection,
+				  Q_ARG(int,sampleRate));
+}
+
+// The pipeline keeps reading the sound device, start() only initializes
+// demodulator and receiver again.
+
+void FaxDecoder::restartSound(const FaxParameters& p)
+{
+	pipeline->setParameters(p);
+	createImage(p.width());
+	QMetaObject::invokeMethod(pipeline->receiver(),"setWidth",
+				  Qt::BlockingQueuedConnection,
+				  Q_ARG(int,p.width()));
+	QMetaObject::invokeMethod(pipeline,"start",
+				  Qt::BlockingQueuedConnection,
+				  Q_ARG(int,soundRate));
+}
+
+void FaxDecoder::endReception(void)
+{
+	if(pipeline) {
+		QMetaObject::invokeMethod(pipeline->receiver(),"endReception",
+					  Qt::QueuedConnection);
+	}
+}
+
+void FaxDecoder::abort(void)
+{
+	stopRequest.storeRelease(1);
+}
+
+double FaxDecoder::audioTime(void) const
+{
+	return seconds;
+}
+
+double FaxDecoder::speed(void) const
+{
+	return elapsed>0 ? seconds/elapsed : 0;
+}
+
+double FaxDecoder::eventTime(FaxSession::EventType type) const
+{
+	return rx ? rx->eventTime(type) : -1;
+}
+
+const QImage& FaxDecoder::getImage(void)
+{
+	return image;
+}
+
+bool FaxDecoder::save(const QString& fileName)
+{
+	return image.save(fileName);
+}
+
+void FaxDecoder::setScanLines(const ScanLines& lines)
+{
+	for(int i=0; i<lines.size(); i++) {
+		const ScanLine& l=lines[i];
+		if(l.first>=image.width()) {
+			continue;
+		}
+		if(l.row>=image.height()) {
+			image=image.copy(0,0,image.width(),l.row+50);
+		}
+		writePixels(image,l.row,
+			    reinterpret_cast<const uchar*>(l.pixels.constData()),
+			    std::min(l.pixels.size(),image.width()-l.first),
+			    l.channel,l.first);
+	}
+}
+
+// same as FaxImage::resize, the receiver cuts off the phasing lines and
+// the unused rows at the end
+
+void FaxDecoder::resize(int x, int y, int w, int h)
+{
+	if(w==0) {
+		w=image.width();
+	}
+	if(h==0) {
+		h=image.height();
+	}
+	image=image.copy(x,y,w,h);
+}
+
+void FaxDecoder::end(void)
+{
+	emit received();
+	if(continuous) {
+		return;
+	}
+	if(pipeline) {
+		QMetaObject::invokeMethod(pipeline,"stop",
+					  Qt::BlockingQueuedConnection);
+		if(sound) {
+			sound->end();
+		}
+	}
+	done=true;
+	emit finished();
+}
@@ -0,0 +1,198 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef FAXDECODER_HPP
+#define FAXDECODER_HPP
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QObject>
+#include <QString>
+#include "FaxParameters.hpp"
+#include "FaxSession.hpp"
+#include "RingBuffer.hpp"
+#include "ScanLine.hpp"
+
+class FaxDemodulator;
+class FaxReceiver;
+class File;
+class ReceptionPipeline;
+class Sound;
+
+/**
+ * Reception without a window. The decoder collects the scan lines in a
+ * QImage instead of a FaxImage, so that it only needs QtCore and QtGui.
+ *
+ * A file is decoded in batch mode: decodeFile() pulls the whole file
+ * through its own FaxDemodulator and FaxReceiver in large blocks, in the
+ * calling thread and without returning to the event loop, so a decoder
+ * can also run in a worker thread without an event loop. Sound is
+ * received in real time through the ReceptionPipeline.
+ */
+
+class FaxDecoder : public QObject {
+	Q_OBJECT
+public:
+	FaxDecoder(QObject* parent);
+	~FaxDecoder(void);
+
+	/**
+	 * Decode an audio file as fast as possible. The call returns when
+	 * the receiver found the end of the image, the file ended or
+	 * abort() was called.
+	 *
+	 * \param fileName is the name of the file
+	 * \param p holds the settings, the IOC gives the width of the image
+	 */
+	void decodeFile(const QString& fileName, const FaxParameters& p);
+
+	/**
+	 * Decode samples that are already in memory, like decodeFile().
+	 *
+	 * \param samples are n samples at sampleRate, they are not changed
+	 */
+	void decodeSamples(const short* samples, size_t n, int sampleRate,
+			   const FaxParameters& p);
+
+	/**
+	 * Save the samples of the last reception as a session file.
+	 */
+	bool saveSession(const QString& fileName);
+
+	/**
+	 * Draw the image of a session file.
+	 *
+	 * \param fileName is the name of the session file
+	 * \param lpm replaces the LPM of the session if it is not 0
+	 * \param width replaces the width of the session if it is not 0
+	 * \param kernel is the LineResampler::Kernel to draw with
+	 * \return false if the file is no session
+	 */
+	bool renderSession(const QString& fileName, double lpm, int width,
+			   int kernel);
+
+	/**
+	 * Start decoding from the sound device. The reception ends with the
+	 * APT stop tone.
+	 *
+	 * \param p holds the settings, the IOC gives the width of the image
+	 * \param continuous keeps the sound device open after the reception,
+	 * received() is emitted and restartSound() waits for the next one
+	 */
+	void startSound(const FaxParameters& p, bool continuous=false);
+
+	/**
+	 * Like startSound(), but the samples come from a ring buffer that is
+	 * filled by someone else, e.g. a channel of a Channelizer.
+	 *
+	 * \param ring is read by the decoder only
+	 * \param sampleRate is the rate of the samples
+	 */
+	void startRing(RingBuffer<short>* ring, int sampleRate,
+		       const FaxParameters& p, bool continuous=false);
+
+	/**
+	 * Wait for the next facsimile from the sound device or ring buffer
+	 * with a new image,
+	 * after received() in continuous mode.
+	 */
+	void restartSound(const FaxParameters& p);
+
+	/**
+	 * End the current reception as if the APT stop tone came.
+	 */
+	void endReception(void);
+
+	/**
+	 * Stop decodeFile() after the current block. This may be called from
+	 * any thread.
+	 */
+	void abort(void);
+
+	/**
+	 * Seconds of audio decoded by the last decodeFile() or
+	 * decodeSamples().
+	 */
+	double audioTime(void) const;
+
+	/**
+	 * Throughput of the last decodeFile() or decodeSamples() as a
+	 * multiple of real time.
+	 */
+	double speed(void) const;
+
+	/**
+	 * Seconds from the start of the last decodeFile() or decodeSamples()
+	 * to the first event of the type, -1 if there was none.
+	 */
+	double eventTime(FaxSession::EventType type) const;
+
+	/**
+	 * The image received so far.
+	 */
+	const QImage& getImage(void);
+
+	/**
+	 * Save the image, the format is taken from the file name.
+	 */
+	bool save(const QString& fileName);
+signals:
+	/**
+	 * An image is complete.
+	 */
+	void received(void);
+
+	/**
+	 * The reception has ended and the devices are closed.
+	 */
+	void finished(void);
+
+	/**
+	 * The APT start tone was found.
+	 */
+	void receptionStarts(void);
+
+	/**
+	 * The phasing lines are over, the image begins.
+	 */
+	void imageStarts(void);
+private slots:
+	void setScanLines(const ScanLines& lines);
+	void resize(int x, int y, int w, int h);
+	void end(void);
+private:
+	void createEngines(void);
+	void connectReceiver(FaxReceiver* rx);
+	void createImage(int width);
+	void startBatch(int sampleRate, const FaxParameters& p);
+	static const int batchSize=65536;
+	FaxDemodulator* demod;
+	FaxReceiver* rx;
+	ReceptionPipeline* pipeline;
+	File* file;
+	Sound* sound;
+	QImage image;
+	QAtomicInt stopRequest;
+	bool done;
+	bool continuous;
+	int soundRate;
+	double seconds;
+	double elapsed;
+};
+
+#endif
@@ -16,22 +16,24 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
-#include "Config.hpp"
 #include "FaxDemodulator.hpp"
+#include "config.h"
+#ifdef USE_STATS
+#include "StageStats.hpp"
+#endif
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <stdint.h>
 
 FaxDemodulator::FaxDemodulator(QObject* parent)	
-	: QObject(parent),iLpf(17),qLpf(17),
-	  sine(8192),cosine(8192),arcSine(256)
+	: QObject(parent),decimation(1),iqLpf(17),decimator(1),
+	  oscillator(13),arcSine(257)
 {
-	for(size_t i=0; i<sine.size(); i++) {
-		sine[i]=std::sin(2.0*M_PI*i/sine.size());
-	}
-	for(size_t i=0; i<cosine.size(); i++) {
-		cosine[i]=std::cos(2.0*M_PI*i/cosine.size());
-	}
+	oscillator.setInterpolation(true);
+	// both ends included, so it can be interpolated up to 1
 	for(size_t i=0; i<arcSine.size(); i++) {
-		arcSine[i]=std::asin(2.0*i/arcSine.size()-1.0)/2.0/M_PI;
+		arcSine[i]=std::asin(2.0*i/(arcSine.size()-1)-1.0)/2.0/M_PI;
 	}
 
         // Narrow, middle and wide fir low pass filter from ACfax
@@ -45,56 +47,215 @@ FaxDemodulator::FaxDemodulator(QObject* parent)
 	}
 };
 
-void FaxDemodulator::init(int sampleRate)
+// The ACfax filters are designed for 8000 Hz, so the signal is never
+// decimated below that. Only factors that divide the sample rate are used
+// to keep the demodulated rate an integer.
+
+static int decimationFactor(int sampleRate, int wanted)
+{
+	int factor=sampleRate/8000;
+	if(wanted>0 && wanted<factor) {
+		factor=wanted;
+	}
+	while(factor>1 && sampleRate%factor!=0) {
+		factor--;
+	}
+	return std::max(factor,1);
+}
+
+// Blackman windowed sinc with the cut off at a quarter of the decimated
+// rate. What folds back into the upper half of the decimated band is
+// removed by the ACfax filter afterwards.
+
+static std::valarray<double> designDecimator(int decimation)
+{
+	const size_t taps=10*decimation+1;
+	const double fc=0.25/decimation;
+	std::valarray<double> c(taps);
+	for(size_t i=0; i<taps; i++) {
+		double m=i-(taps-1)/2.0;
+		double w=0.42-0.5*std::cos(2.0*M_PI*i/(taps-1))
+			+0.08*std::cos(4.0*M_PI*i/(taps-1));
+		c[i] = m==0 ? 2.0*fc : std::sin(2.0*M_PI*fc*m)/(M_PI*m);
+		c[i]*=w;
+	}
+	c/=c.sum();
+	return c;
+}
+
+int FaxDemodulator::init(int sampleRate, const FaxParameters& p)
 {
-	rate=sampleRate;
-	Config& config=Config::instance();
-	size_t filter=config.readNumEntry("/hamfax/modulation/filter");
-	iLpf.setCoeffs(lowPassFilter[filter]);
-	qLpf.setCoeffs(lowPassFilter[filter]);
-	deviation=config.readNumEntry("/hamfax/modulation/deviation");
-	int carrier=config.readNumEntry("/hamfax/modulation/carrier");
-	fm=config.readBoolEntry("/hamfax/modulation/FM");
-	sine.setIncrement(sine.size()*carrier/rate);
-	cosine.setIncrement(cosine.size()*carrier/rate);
-	sine.reset();
-	cosine.reset();
+	decimation=decimationFactor(sampleRate,p.decimation);
+	rate=sampleRate/decimation;
+	size_t filter=p.filter;
+	iqLpf.setCoeffs(lowPassFilter[filter]);
+	deviation=p.deviation;
+	int carrier=p.carrier;
+	fm=p.fm;
+	fastDiscriminator=p.fastDiscriminator;
+	fmScale=rate/(2.0*M_PI*deviation);
+	oscillator.setRate(sampleRate);
+	oscillator.setFrequency(carrier);
+	oscillator.reset();
 	ifirold=qfirold=0;
+	iold=qold=pold=0;
+	std::valarray<double> c=designDecimator(decimation);
+	if(decimation>1) {
+		decimator.setCoeffs(c);
+		decimator.setDecimation(decimation);
+	}
+	fixedPoint=p.fixedPoint;
+	if(fixedPoint) {
+		fixed.init(sampleRate,carrier,deviation,fm,
+			   lowPassFilter[filter],c,decimation);
+	}
+	return rate;
 }
 
 void FaxDemodulator::newSamples(short* audio, int n)
 {
-	int demod[n];
+	if(n<=0) {
+		emit data(0,0);
+		return;
+	}
+#ifdef USE_STATS
+	StageTimer timer(StageStats::DEMODULATOR,n);
+#endif
+	if(demodBuffer.size()<static_cast<size_t>(n)) {
+		demodBuffer.resize(n);
+	}
+	int* demod=&demodBuffer[0];
+	if(fixedPoint) {
+		n=fixed.demodulate(audio,n,demod);
+		if(n>0) {
+			emit data(demod,n);
+		}
+		return;
+	}
+	if(iqBuffer.size()<2*static_cast<size_t>(n)) {
+		iqBuffer.resize(2*n);
+	}
+	double* iq=&iqBuffer[0];
+	oscillator.sinCosBlock(iq,n);
+	for(int i=0; i<n; i++) {
+		iq[2*i]*=audio[i];
+		iq[2*i+1]*=audio[i];
+	}
+	if(decimation>1) {
+		n=decimator.decimateBlock(iq,iq,n);
+		if(n==0) {
+			return;
+		}
+	}
+	iqLpf.filterBlock(iq,iq,n);
+
+	if(!fm) {
+		demodulateAM(iq,demod,n);
+	} else if(fastDiscriminator) {
+		discriminateFast(iq,demod,n);
+	} else {
+		discriminateTable(iq,demod,n);
+	}
+	emit data(demod,n);
+}
+
+void FaxDemodulator::demodulateAM(const double* iq, int* demod, int n)
+{
 	for(int i=0; i<n; i++) {
-		double ifirout=iLpf.filterSample(audio[i]*cosine.nextValue());
-		double qfirout=qLpf.filterSample(audio[i]*sine.nextValue());
-		if(fm) {
-			double abs=std::sqrt(qfirout*qfirout+ifirout*ifirout);
+		double ifirout=iq[2*i]/96000;
+		double qfirout=iq[2*i+1]/96000;
+		demod[i]=static_cast<int>
+			(std::sqrt(ifirout*ifirout+qfirout*qfirout));
+	}
+}
+
+// The table is interpolated linearly. In the range of the phase steps of
+// a fax signal this is exact to far less than a grey level, so the other
+// discriminators can be compared with this one.
+
+void FaxDemodulator::discriminateTable(const double* iq, int* demod, int n)
+{
+	const size_t last=arcSine.size()-1;
+	for(int i=0; i<n; i++) {
+		double ifirout=iq[2*i];
+		double qfirout=iq[2*i+1];
+		double abs=std::sqrt(qfirout*qfirout+ifirout*ifirout);
+		// a sample of zero gives no direction, like in discriminateFast
+		if(abs>0) {
 			ifirout/=abs;
 			qfirout/=abs;
-			if(abs>10000) {
-				double y=qfirold*ifirout-ifirold*qfirout;
-				y=(y+1.0)/2.0*arcSine.size();
-				double x=static_cast<double>(rate)/deviation;
-				x*=arcSine[static_cast<size_t>(y)];
-				if(x<-1.0) {
-					x=-1.0;
-				} else if(x>1.0) {
-					x=1.0;
-				}
-				demod[i]=static_cast<int>((x/2.0+0.5)*255.0);
-			} else {
-				demod[i]=0;
+		}
+		if(abs>10000) {
+			double y=qfirold*ifirout-ifirold*qfirout;
+			y=std::min(std::max(y,-1.0),1.0);
+			y=(y+1.0)/2.0*last;
+			size_t k=std::min(static_cast<size_t>(y),last-1);
+			double x=static_cast<double>(rate)/deviation;
+			x*=arcSine[k]+(y-k)*(arcSine[k+1]-arcSine[k]);
+			if(x<-1.0) {
+				x=-1.0;
+			} else if(x>1.0) {
+				x=1.0;
 			}
+			demod[i]=static_cast<int>((x/2.0+0.5)*255.0);
 		} else {
-			ifirout/=96000;
-			qfirout/=96000;
-			demod[i]=static_cast<int>
-				(std::sqrt(ifirout*ifirout+qfirout*qfirout));
+			demod[i]=0;
 		}
-
 		ifirold=ifirout;
 		qfirold=qfirout;
 	}
-	emit data(demod,n);
+}
+
+// 1/sqrt(r) from the well known bit trick and three Newton steps, which
+// leaves a relative error of about 1e-11.
+
+static inline double invSqrt(double r)
+{
+	int64_t bits;
+	std::memcpy(&bits,&r,sizeof(bits));
+	bits=0x5fe6eb50c7b537a9LL-(bits>>1);
+	double y;
+	std::memcpy(&y,&bits,sizeof(y));
+	y*=1.5-0.5*r*y*y;
+	y*=1.5-0.5*r*y*y;
+	y*=1.5-0.5*r*y*y;
+	return y;
+}
+
+// Taylor series of asin. The phase step of a fax signal stays well below
+// 0.5 rad, where the error is below 1e-5 rad.
+
+static inline double arcSinePoly(double y)
+{
+	double y2=y*y;
+	return y*(1.0+y2*(1.0/6+y2*(3.0/40+y2*(15.0/336+y2*35.0/1152))));
+}
+
+// Same discriminator as discriminateTable, but without divisions and
+// branches, so the compiler can vectorize the loop: the cross product of
+// two successive samples is normalized by 1/sqrt(|s_t|^2 |s_{t-1}|^2)
+// instead of normalizing every sample on its own.
+
+void FaxDemodulator::discriminateFast(const double* iq, int* demod, int n)
+{
+	double i1=iold;
+	double q1=qold;
+	double p1=pold;
+	for(int k=0; k<n; k++) {
+		double i0=iq[2*k];
+		double q0=iq[2*k+1];
+		double p0=i0*i0+q0*q0;
+		double y=(q1*i0-i1*q0)*invSqrt(std::max(p0*p1,1e-300));
+		y=std::min(std::max(y,-1.0),1.0);
+		double x=arcSinePoly(y)*fmScale;
+		x=std::min(std::max(x,-1.0),1.0);
+		int v=static_cast<int>((x/2.0+0.5)*255.0);
+		demod[k] = p0>1e8 ? v : 0;
+		i1=i0;
+		q1=q0;
+		p1=p0;
+	}
+	iold=i1;
+	qold=q1;
+	pold=p1;
 }
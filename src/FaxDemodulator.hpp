@@ -20,8 +20,12 @@
 #define FAXDEMODULATOR_HPP
 
 #include <qobject.h>
-#include "FirFilter.hpp"
+#include <vector>
+#include "FaxParameters.hpp"
+#include "FixedDemodulator.hpp"
+#include "IQFirFilter.hpp"
 #include "LookUpTable.hpp"
+#include "Nco.hpp"
 
 /**
  * AM and FM demodulator. The demodulator takes the raw stream from
@@ -48,26 +52,64 @@
  *
  * \f[ y_{t-1} = I_{t-1} Q_t - Q_{t-1} I_t \f]
  * \f[ y_{t-1} = sin(2\pi ft - 2\pi f) \f]
+ *
+ * There are two implementations of this discriminator. The original one
+ * normalizes every sample and looks up asin in an interpolated table. The
+ * fast one normalizes the cross product with 1/sqrt(|s_t|^2 |s_{t-1}|^2)
+ * and approximates asin by a polynomial, so it needs no divisions and no
+ * branches. It is selected with FaxParameters::fastDiscriminator. Both
+ * give the same grey values within one level.
+ *
+ * With FaxParameters::fixedPoint the whole chain runs in integer
+ * arithmetic in FixedDemodulator instead.
+ *
+ * Both low pass filters share their coefficients, so I and Q are kept
+ * interleaved and filtered together by one IQFirFilter.
+ *
+ * For sample rates above 8000 Hz the mixed signal is first decimated by a
+ * polyphase low pass, so that the ACfax filters, the discriminator and
+ * everything after the demodulator run at (about) 8000 Hz.
  */
 
 class FaxDemodulator : public QObject {
 	Q_OBJECT
 public:
 	FaxDemodulator(QObject* parent);
-        void init(int sampleRate);
+
+	/**
+	 * Get ready for a new reception.
+	 *
+	 * \param sampleRate is the rate of the audio samples
+	 * \param p holds the modulation settings
+	 * \return the rate of the demodulated signal, which is lower than
+	 * sampleRate when the signal gets decimated
+	 */
+	int init(int sampleRate, const FaxParameters& p);
 private:
-	typedef FirFilter<double> LPF;
+	typedef IQFirFilter<double> LPF;
+	void demodulateAM(const double* iq, int* demod, int n);
+	void discriminateTable(const double* iq, int* demod, int n);
+	void discriminateFast(const double* iq, int* demod, int n);
 	int rate;
+	int decimation;
 	int deviation;
 	bool fm;
-	LPF iLpf;
-	LPF qLpf;
-	LookUpTable<double> sine;
-	LookUpTable<double> cosine;
+	bool fastDiscriminator;
+	bool fixedPoint;
+	FixedDemodulator fixed;
+	double fmScale;
+	LPF iqLpf;
+	LPF decimator;
+	Nco<double> oscillator;
 	LookUpTable<double> arcSine;
 	double ifirold;
 	double qfirold;
+	double iold;
+	double qold;
+	double pold;
 	std::valarray<double> lowPassFilter[3];
+	std::valarray<double> iqBuffer;
+	std::vector<int> demodBuffer;
 public slots:
 	void newSamples(short* audio, int n);
 signals:
@@ -19,8 +19,13 @@
 #include "FaxImage.hpp"
 #include "Config.hpp"
 #include "ImageWidget.hpp"
+#include "config.h"
+#ifdef USE_STATS
+#include "StageStats.hpp"
+#endif
 #include <QMouseEvent>
 #include <QImageWriter>
+#include <algorithm>
 
 FaxImage::FaxImage(QWidget* parent)
 	: QScrollArea(parent)
@@ -39,6 +44,11 @@ int FaxImage::getCols(void)
 	return image.width();
 }
 
+const QImage& FaxImage::getImage(void)
+{
+	return image;
+}
+
 int FaxImage::getPixel(int col, int row, int rgbg)
 {
 	QRgb pixel=image.pixel(col,row);
@@ -92,6 +102,44 @@ bool FaxImage::setPixel(int col, int row, int value, int rgbg)
 	return true;
 }
 
+bool FaxImage::scanline(int row, const uchar* pixels, int width,
+			int rgbg, int first)
+{
+	if(first>=image.width() || row>=image.height()+1) {
+		return false;
+	}
+	if(row>=image.height()) {
+		resizeHeight(50);
+	}
+	width=std::min(width,image.width()-first);
+	writePixels(image,row,pixels,width,rgbg,first);
+	widget()->update(first, row, width, 1);
+	return true;
+}
+
+void FaxImage::setScanLines(const ScanLines& lines)
+{
+#ifdef USE_STATS
+	int pixels=0;
+	for(int i=0; i<lines.size(); i++) {
+		pixels+=lines[i].pixels.size();
+	}
+	StageTimer timer(StageStats::IMAGE,pixels);
+#endif
+	int last=-1;
+	for(int i=0; i<lines.size(); i++) {
+		const ScanLine& l=lines[i];
+		if(scanline(l.row,
+			    reinterpret_cast<const uchar*>(l.pixels.constData()),
+			    l.pixels.size(),l.channel,l.first)) {
+			last=l.row;
+		}
+	}
+	if(autoScroll && last>=0) {
+		ensureVisible(0,last,0,0);
+	}
+}
+
 void FaxImage::resizeHeight(int h)
 {
 	int imageW=image.width();
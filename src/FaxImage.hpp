@@ -24,6 +24,7 @@
 #include <QLabel>
 #include <QScrollArea>
 #include <qstring.h>
+#include "ScanLine.hpp"
 
 class FaxImage : public QScrollArea {
 	Q_OBJECT
@@ -32,6 +33,23 @@ public:
 	int getRows(void);
 	int getCols(void);
 	int getPixel(int col, int row, int rgbg);
+	const QImage& getImage(void);
+
+	/**
+	 * Write a run of pixels into one row of the image, with one update
+	 * of the widget for the whole run.
+	 *
+	 * \param row is the row in the image, which grows by 50 rows if row
+	 * is just below the last row
+	 * \param pixels holds the grey values
+	 * \param width is the number of pixels
+	 * \param rgbg is 0, 1 or 2 to set the red, green or blue part, or 3
+	 * for grey
+	 * \param first is the column of the first pixel
+	 * \return false if the row or the first column is out of range
+	 */
+	bool scanline(int row, const uchar* pixels, int width, int rgbg,
+		      int first=0);
 	void load(QString fileName);
 	bool save(QString fileName);
 private:
@@ -56,6 +74,7 @@ signals:
 	void shiftLine(double);
 public slots:
         bool setPixel(int col, int row, int value, int rgbg);
+	void setScanLines(const ScanLines& lines);
         void create(int cols, int rows);
 	void scale(int width, int height);
 	void scale(int width);
@@ -16,29 +16,22 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
-#include "Config.hpp"
 #include "FaxModulator.hpp"
-#include <cmath>
 
 FaxModulator::FaxModulator(QObject* parent)
-	: QObject(parent), sine(8192)
+	: QObject(parent), sine(13,32767)
 {
-	for(size_t i=0; i<sine.size(); i++) {
-		sine[i]=static_cast<short>(32767*std::sin(2.0*M_PI*i/sine.size()));
-	}
+	sine.setInterpolation(true);
 }
 
-void FaxModulator::init(int sampleRate)
+void FaxModulator::init(int sampleRate, const FaxParameters& p)
 {
-	Config& config=Config::instance();
-	carrier=config.readNumEntry("/hamfax/modulation/carrier");
-	dev=config.readNumEntry("/hamfax/modulation/deviation");
-	fm=config.readBoolEntry("/hamfax/modulation/FM");
-	this->sampleRate=sampleRate;
+	carrier=p.carrier;
+	dev=p.deviation;
+	fm=p.fm;
+	sine.setRate(sampleRate);
+	sine.setFrequency(carrier);
 	sine.reset();
-	if(!fm) {
-		sine.setIncrement(sine.size()*carrier/sampleRate);
-	}
 }
 
 void FaxModulator::modulate(double* buffer, int number)
@@ -46,11 +39,10 @@ void FaxModulator::modulate(double* buffer, int number)
 	short sample[number];
 	for(size_t i=0; i<static_cast<size_t>(number); i++) {
 		if(fm) {
-			int f=static_cast<int>(carrier+2.*(buffer[i]-0.5)*dev);
-			sine.setIncrement(sine.size()*f/sampleRate);
-			sample[i]=sine.nextValue();
+			sine.setFrequency(carrier+2.*(buffer[i]-0.5)*dev);
+			sample[i]=sine.nextSine();
 		} else {
-			sample[i]=static_cast<short>(sine.nextValue()*buffer[i]);
+			sample[i]=static_cast<short>(sine.nextSine()*buffer[i]);
 		}
 	}
 	emit data(sample,number);
@@ -20,7 +20,8 @@
 #define FAXMODULATOR_HPP
 
 #include <qobject.h>
-#include "LookUpTable.hpp"
+#include "FaxParameters.hpp"
+#include "Nco.hpp"
 
 /**
  * Create modulated signal. This class creates the modulated FM or AM
@@ -42,14 +43,14 @@ public:
 	 * Initialize everything to get ready for transmission.
          *
 	 * \param sampleRate sets the sample rate for the transmission
+	 * \param p holds carrier, deviation and modulation
 	 */
-        void init(int sampleRate);
+        void init(int sampleRate, const FaxParameters& p);
 private:
-	int sampleRate;
 	bool fm;
 	int carrier;
 	int dev;
-	LookUpTable<short> sine;
+	Nco<short> sine;
 signals:
 	/**
 	 * The signal is emitted with an array holding the modulated signal 
@@ -0,0 +1,76 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef FAXPARAMETERS_HPP
+#define FAXPARAMETERS_HPP
+
+#include <cmath>
+
+/**
+ * Settings of one reception or transmission. The engines get a copy of
+ * them when they start instead of looking into the configuration, so
+ * several decoders with different settings can run at the same time.
+ * The default values are the defaults of the configuration.
+ */
+
+struct FaxParameters {
+	FaxParameters(void)
+		: carrier(1900), deviation(400), filter(1), fm(true),
+		  decimation(0), fastDiscriminator(true), fixedPoint(false),
+		  lpm(120), ioc(288), color(false),
+		  aptStartFrequency(300), aptStartLength(5),
+		  aptStopFrequency(450), aptStopLength(5), aptDwell(250),
+		  phasingLines(20), phaseInvert(false), memoryLimit(0),
+		  kernel(0), slantTracking(true)
+	{
+	}
+
+	/**
+	 * Number of pixels per line for the IOC.
+	 */
+	int width(void) const
+	{
+		return static_cast<int>(M_PI*ioc);
+	}
+
+	int carrier;              // carrier frequency in Hz
+	int deviation;            // FM deviation in Hz
+	int filter;               // ACfax low pass: narrow, middle or wide
+	bool fm;                  // FM, otherwise AM
+	int decimation;           // largest decimation factor, 0 for auto
+	bool fastDiscriminator;   // division free FM discriminator
+	bool fixedPoint;          // integer demodulator
+	int lpm;                  // lines per minute
+	int ioc;                  // index of cooperation
+	bool color;               // every row is sent as red, green, blue
+	int aptStartFrequency;    // APT start tone in Hz
+	int aptStartLength;       // APT start tone in seconds
+	int aptStopFrequency;     // APT stop tone in Hz
+	int aptStopLength;        // APT stop tone in seconds
+	int aptDwell;             // ms an APT tone is heard before it counts
+	int phasingLines;         // number of phasing lines sent
+	bool phaseInvert;         // phasing lines are white with a black pulse
+	int memoryLimit;          // MB of received samples kept in memory,
+	                          // the rest goes to a temporary file, 0 for
+	                          // no limit
+	int kernel;               // pixel reconstruction, a
+	                          // LineResampler::Kernel
+	bool slantTracking;       // correct the LPM while receiving
+};
+
+#endif
@@ -16,224 +16,447 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
-#include "Config.hpp"
 #include "FaxReceiver.hpp"
+#include "config.h"
+#ifdef USE_STATS
+#include "StageStats.hpp"
+#endif
+#include <QRunnable>
+#include <algorithm>
 #include <cmath>
 
+// rows drawn by one task of the redraw pool
+static const int redrawBlock=32;
+
+// Draws a block of rows in a thread of the pool. The rows are either kept
+// in result or handed over to the receiver, which emits them in its own
+// thread.
+
+class RedrawTask : public QRunnable {
+public:
+	RedrawTask(QObject* receiver, const ImageRenderer& renderer,
+		   int first, int n, int generation, ScanLines* result)
+		: receiver(receiver), renderer(renderer), first(first), n(n),
+		  generation(generation), result(result)
+	{
+	}
+	void run(void)
+	{
+		ScanLines lines;
+		renderer.render(first,n,lines);
+		if(result) {
+			*result=lines;
+		} else {
+			QMetaObject::invokeMethod(receiver,"rowsDrawn",
+						  Qt::QueuedConnection,
+						  Q_ARG(ScanLines,lines),
+						  Q_ARG(int,generation));
+		}
+	}
+private:
+	QObject* receiver;
+	ImageRenderer renderer;
+	int first;
+	int n;
+	int generation;
+	ScanLines* result;
+};
+
 FaxReceiver::FaxReceiver(QObject* parent)
-	: QObject(parent), rawData(0)
+	: QObject(parent), state(DONE), sampleRate(0), aptTail(1), lpm(0),
+	  width(0), color(false), kernel(0), slantTracking(false), lineRow(-1),
+	  lineCols(0), sampleCount(0), origin(0), redrawPending(0),
+	  redrawGeneration(0)
 {
-	timer=new QTimer(this);
-	connect(timer,SIGNAL(timeout()),this,SLOT(adjustNext()));
+	qRegisterMetaType<ScanLines>("ScanLines");
 }
 
-void FaxReceiver::init(int sampleRate)
+void FaxReceiver::init(int sampleRate, const FaxParameters& p)
 {
-	Config& config=Config::instance();
-	aptStartFreq=config.readNumEntry("/hamfax/APT/startFrequency");
-	aptStopFreq=config.readNumEntry("/hamfax/APT/stopFrequency");
-	txLPM=config.readNumEntry("/hamfax/fax/LPM");
-	phaseInvers=config.readBoolEntry("/hamfax/phasing/invert");
-	color=config.readBoolEntry("/hamfax/fax/color");
+	aptStartFreq=p.aptStartFrequency;
+	aptStopFreq=p.aptStopFrequency;
+	txLPM=p.lpm;
+	phaseInvers=p.phaseInvert;
+	color=p.color;
+	kernel=p.kernel;
+	slantTracking=p.slantTracking;
 	this->sampleRate=sampleRate;
 	state=APTSTART;
-	aptCount=aptTrans=0;
-	aptStop=aptHigh=false;
+	aptDwell=p.aptDwell/1000.0;
+	aptTail=1;
+	setupApt();
 	imageSample=0;
-	rawData.resize(1024*1024*8);
+	lastRow=0;
+	rowSamples.clear();
+	lineRow=-1;
+	cancelRedraw();
+	rawData.setMemoryLimit(static_cast<size_t>(p.memoryLimit)<<20);
+	rawData.truncate(0);
+	session.close();
+	events.resize(0);
+	sampleCount=origin=0;
 	emit startReception();
 }
 
 void FaxReceiver::decode(int* buf, int n)
 {
+#ifdef USE_STATS
+	StageTimer timer(StageStats::RECEIVER,n);
+#endif
 	if(n==0) endReception();
 	for(int i=0; i<n; i++) {
-		currentValue=buf[i];
 		decodeApt(buf[i]);
 		if(state==PHASING) {
 			decodePhasing(buf[i]);
 		}
 		if((state==PHASING||state==IMAGE)&&lpm>0) {
-			if(static_cast<int>(rawData.size())<=imageSample) {
-				rawData.resize(rawData.size()+1024*1024);
-			}
+			rawData.put(imageSample,buf[i]);
 			decodeImage(buf[i]);
 		}
+		sampleCount++;
 	}
+	flushLines();
 }
 
-// The number of transistions between black and white is counted. After 1/2 
-// second, the frequency is calculated. If it matches the APT start frequency,
-// the state skips to the detection of phasing lines, if it matches the apt
-// stop frequency two times, the reception is ended.
+// The APT detector looks at blocks of 40ms. If it finds the APT start
+// tone for the dwell time, the state skips to the detection of phasing
+// lines, if it finds the APT stop tone for twice the dwell time, the
+// reception is ended. The frequency is reported every fifth block or when
+// it changes.
 
 void FaxReceiver::decodeApt(const int& x)
 {
-	if(x>229 && !aptHigh) {
-		aptHigh=true;
-		aptTrans++;
-	} else if(x<25 && aptHigh) {
-		aptHigh=false;
-	}
-	if(++aptCount >= sampleRate/2) {
-		int f=sampleRate*aptTrans/aptCount;
-		aptCount=aptTrans=0;
-		emit aptFound(f);
-		if(state==APTSTART) {
-			if(f==aptStartFreq) {
-				skip();
-			}
-		} else {
-			if(f==aptStopFreq) {
-				if(aptStop) {
-					endReception();
-				} else {
-					aptStop=true;
-				}
-			}
+	if(!apt.process(x)) {
+		return;
+	}
+	int f=apt.frequency();
+	if(f!=aptFreq || ++aptBlocks>=5) {
+		emit aptFound(f,apt.confidence());
+		aptBlocks=0;
+	}
+	if(f!=aptFreq) {
+		addEvent(FaxSession::APT,f);
+		aptFreq=f;
+	}
+	if(state==APTSTART) {
+		if(f==aptStartFreq && apt.duration()>=aptDwell) {
+			skip();
 		}
+	} else if(state!=DONE && f==aptStopFreq
+		  && apt.duration()>=2*aptDwell) {
+		aptTail=apt.duration();
+		endReception();
+	}
+}
+
+// The detector looks for the usual APT tones and the configured ones.
+
+void FaxReceiver::setupApt(void)
+{
+	if(sampleRate<=0) {
+		return;
+	}
+	std::vector<int> tones;
+	tones.push_back(300);
+	tones.push_back(450);
+	tones.push_back(675);
+	if(std::find(tones.begin(),tones.end(),aptStartFreq)==tones.end()) {
+		tones.push_back(aptStartFreq);
 	}
+	if(std::find(tones.begin(),tones.end(),aptStopFreq)==tones.end()) {
+		tones.push_back(aptStopFreq);
+	}
+	apt.init(sampleRate,tones);
+	aptFreq=aptBlocks=0;
 }
 
 // Phasing lines consist of 2.5% white at the beginning, 95% black and again
-// 2.5% white at the end (or inverted). In normal phasing lines we try to
-// count the length between the white-black transitions. If the line has
-// a reasonable amount of black (4.8%--5.2%) and the length fits in the 
-// range of 60--360lpm (plus some tolerance) it is considered a valid
-// phasing line. Then the start of a line and the lpm is calculated.
+// 2.5% white at the end (or inverted). With every phasing line found, the
+// detector gives a better LPM and line start and the image is started
+// again from there. When the phasing lines are over, the image begins.
 
 void FaxReceiver::decodePhasing(const int& x)
 {
-	currPhaseLength++;
-	if(x>128) {
-		currPhaseHigh++;
-	}
-	if((!phaseInvers && x>229 && !phaseHigh) ||
-	   ( phaseInvers && x<25  && phaseHigh)) {
-		phaseHigh=phaseInvers?false:true;
-	} else if((!phaseInvers && x<25 && phaseHigh) ||
-		  ( phaseInvers && x>229 && !phaseHigh)) {
-		phaseHigh=phaseInvers?true:false;
-		if(currPhaseHigh>=(phaseInvers?0.948:0.048)*currPhaseLength &&
-		   currPhaseHigh<=(phaseInvers?0.952:0.052)*currPhaseLength &&
-		   static_cast<double>(currPhaseLength)<=1.1*sampleRate &&
-		   static_cast<double>(currPhaseLength)>=0.15*sampleRate) {
-			double l=60.0*sampleRate/currPhaseLength;
-			emit phasingLine(l);
-			lpmSum+=l;
-			++phaseLines;
-			lpm=lpmSum/phaseLines;
-			imageSample=static_cast<int>(1.025*60./lpm*sampleRate);
-			noPhaseLines=0;
-		} else if(phaseLines>0 && ++noPhaseLines>=5) {
-			state=IMAGE;
-			double pos=std::fmod(imageSample,sampleRate*60/lpm);
-			pos/=sampleRate*60.0/lpm;
-			lastCol=static_cast<int>(pos*width);
-			pixel=pixelSamples=0;
-			lastRow=99; // just !=0 which is the first row
-			emit imageStarts();
-		} else if(currPhaseLength>5*sampleRate) {
-			currPhaseLength=0;
-		}
-		currPhaseLength=currPhaseHigh=0;
+	switch(phasing.process(x)) {
+	case PhasingDetector::LINE:
+		emit phasingLine(phasing.lpm());
+		addEvent(FaxSession::PHASING,
+			 static_cast<int>(phasing.lpm()+0.5));
+		lpm=phasing.lpm();
+		setupLine();
+		// the current sample is in the line after the phasing line
+		imageSample=static_cast<int>
+			(std::floor(60.0*sampleRate/lpm+phasing.sinceStart()
+				    +0.5));
+		break;
+	case PhasingDetector::END:
+		state=IMAGE;
+		lastRow=99; // just !=0 which is the first row
+		origin=sampleCount-imageSample;
+		addEvent(FaxSession::IMAGE,0);
+		emit imageStarts();
+		break;
+	default:
+		break;
 	}
 }
 
+// The samples of the current row are collected, the pixels are computed
+// as soon as all samples they need are there. If imageSample jumps while
+// the phasing lines are adjusted, the row starts again. Rows are counted
+// from rowBase at sampleBase, where the LPM was corrected last.
+
 void FaxReceiver::decodeImage(const int& x)
 {
-	int col=static_cast<int>(width*std::fmod(imageSample,sampleRate*60/lpm)
-				 /sampleRate/60.0*lpm);
-	int currRow=static_cast<int>(imageSample*lpm/60.0/sampleRate);
-	rawData[imageSample]=x;
-	if(col==lastCol) {
-		pixel+=x;
-		pixelSamples++;
-	} else {
-		if(pixelSamples>0) {
-			pixel/=pixelSamples;
-			emit setPixel(lastCol, color?currRow/3:currRow, 
-				      pixel,color?currRow%3:3);
-			if(lastRow!=currRow && state!=PHASING) {
-				emit row((lastRow=currRow)/(color?3:1));
-			}
+	int currRow=rowBase+static_cast<int>((imageSample-sampleBase)
+					     /samplesPerLine);
+	if(currRow!=lineRow && nextSamplesPerLine>0) {
+		sampleBase=rowStart(currRow);
+		rowBase=currRow;
+		samplesPerLine=nextSamplesPerLine;
+		nextSamplesPerLine=0;
+		lpm=60.0*sampleRate/samplesPerLine;
+		resampler.setup(samplesPerLine,width,kernel);
+	}
+	int pos=imageSample-rowStart(currRow);
+	if(currRow!=lineRow || pos!=static_cast<int>(rowSamples.size())) {
+		drawLine();
+		if(lastRow!=currRow && state!=PHASING) {
+			emit row((lastRow=currRow)/(color?3:1));
 		}
-		lastCol=col;
-		pixel=x;
-		pixelSamples=1;
+		lineRow=currRow;
+		lineCols=0;
+		rowSamples.assign(std::max(pos,0),x);
 	}
+	rowSamples.push_back(x);
 	imageSample++;
 }
 
-void FaxReceiver::correctLPM(double d)
+int FaxReceiver::rowStart(int row) const
 {
-	// the setting could have changed
-	color=Config::instance().readBoolEntry("/hamfax/fax/color");
+	return sampleBase+static_cast<int>(std::ceil((row-rowBase)
+						     *samplesPerLine));
+}
+
+void FaxReceiver::setupLine(void)
+{
+	if(lpm>0) {
+		drawLine();
+		samplesPerLine=60.0*sampleRate/lpm;
+		resampler.setup(samplesPerLine,width,kernel);
+		linePixels.resize(width);
+		// rows of the same color are compared
+		slant.init(width,color ? 48 : 16);
+	}
+	lineRow=-1;
+	rowBase=sampleBase=0;
+	nextSamplesPerLine=0;
+	rowSamples.clear();
+}
+
+// During a reception only the tables of the resampler are made again, the
+// current row goes on and is drawn again from its first column. The rows
+// are still counted from rowBase with the tracked line length, and the
+// slant tracker keeps its rows unless they have another width now.
+
+void FaxReceiver::updateLine(void)
+{
+	if((state!=PHASING && state!=IMAGE) || lpm<=0) {
+		setupLine();
+		return;
+	}
+	resampler.setup(samplesPerLine,width,kernel);
+	if(linePixels.size()!=width) {
+		linePixels.resize(width);
+		slant.init(width,color ? 48 : 16);
+	} else if(lineCols==width) {
+		// complete and already given to the slant tracker
+		return;
+	}
+	lineCols=0;
+}
+
+// A drift of s pixels per row means that a line really has
+// samplesPerLine*(1+s/width) samples. Smaller drifts than 0.01 pixels per
+// row are within the precision of the tracker. The new line length is
+// taken at the start of the next row.
+
+void FaxReceiver::trackSlant(void)
+{
+	const unsigned char* pixels=
+		reinterpret_cast<const unsigned char*>(linePixels.constData());
+	if(!slant.addRow(pixels)) {
+		return;
+	}
+	double s=slant.drift();
+	if(std::fabs(s)>=0.01) {
+		nextSamplesPerLine=samplesPerLine*(1+s/width);
+		slant.reset();
+	}
+}
+
+void FaxReceiver::drawLine(void)
+{
+	if(rowSamples.empty()) {
+		return;
+	}
+	int first=lineCols;
+	lineCols=resampler.resample(&rowSamples[0],rowSamples.size(),first,
+		reinterpret_cast<unsigned char*>(linePixels.data()));
+	if(lineCols>first) {
+		ScanLine l;
+		l.row=color ? lineRow/3 : lineRow;
+		l.channel=color ? lineRow%3 : 3;
+		l.first=first;
+		l.pixels=linePixels.mid(first,lineCols-first);
+		lines.append(l);
+		if(lineCols==width && state==IMAGE && slantTracking) {
+			trackSlant();
+		}
+	}
+}
+
+void FaxReceiver::flushLines(void)
+{
+	drawLine();
+	if(!lines.isEmpty()) {
+		emit scanLines(lines);
+		lines.clear();
+	}
+}
+
+// A change of the color setting comes in through setColor() before.
 
-	pixel=pixelSamples=imageSample=0;
-	lastCol=99;
+void FaxReceiver::correctLPM(double d)
+{
 	lpm*= 1.0 + (color ? d/3.0 : d);
-	rawIt=rawData.begin();
-	timer->start(0);
-	emit redrawStarts();
+	startRedraw();
 }
 
 void FaxReceiver::correctWidth(int w)
 {
-	pixel=pixelSamples=imageSample=0;
-	lastCol=99;
 	width=w;
 	if(rawData.isEmpty()) {
 		emit imageWidth(w);
 	} else {
-		rawIt=rawData.begin();
-		timer->start(0);
-		emit newSize(0,0,w,0);
-		emit redrawStarts();
+		startRedraw();
 	}
 }
 
-void FaxReceiver::adjustNext(void)
+// The image gets its final height first, so the blocks can be written in
+// whatever order they get ready.
+
+void FaxReceiver::startRedraw(void)
 {
-	for(int i=0; i<512; i++) {
-		if(rawIt++>=rawData.end()) {
-			timer->stop();
-			endReception();
-			break;
-		}
-		decodeImage(*rawIt);
+	cancelRedraw();
+	renderer=ImageRenderer(&rawData,sampleRate,lpm,width,color,kernel);
+	int rows=renderer.rows();
+	emit newSize(0,0,width,renderer.imageRows());
+	emit redrawStarts();
+	for(int r=0; r<rows; r+=redrawBlock) {
+		redrawPool.start(new RedrawTask(this,renderer,r,
+						std::min(redrawBlock,rows-r),
+						redrawGeneration,0));
+		redrawPending++;
+	}
+	if(redrawPending==0) {
+		finishRedraw();
+	}
+}
+
+void FaxReceiver::rowsDrawn(const ScanLines& lines, int generation)
+{
+	if(generation!=redrawGeneration) {
+		return;
+	}
+	emit scanLines(lines);
+	if(--redrawPending==0) {
+		finishRedraw();
+	}
+}
+
+// Rows of a redraw that is still running must not come in anymore, and the
+// samples must stay untouched while the threads read them.
+
+void FaxReceiver::cancelRedraw(void)
+{
+	redrawPool.waitForDone();
+	redrawGeneration++;
+	redrawPending=0;
+}
+
+void FaxReceiver::finishRedraw(void)
+{
+	imageSample=static_cast<int>(rawData.size());
+	lastRow=renderer.rows()-1;
+	rowSamples.clear();
+	finishReception();
+}
+
+void FaxReceiver::redraw(double lpm)
+{
+	cancelRedraw();
+	if(lpm>0) {
+		this->lpm=lpm;
+	}
+	renderer=ImageRenderer(&rawData,sampleRate,this->lpm,width,color,
+			       kernel);
+	int rows=renderer.rows();
+	QVector<ScanLines> blocks((rows+redrawBlock-1)/redrawBlock);
+	for(int b=0; b<blocks.size(); b++) {
+		int r=b*redrawBlock;
+		redrawPool.start(new RedrawTask(this,renderer,r,
+						std::min(redrawBlock,rows-r),
+						redrawGeneration,&blocks[b]));
+	}
+	redrawPool.waitForDone();
+	emit newSize(0,0,width,renderer.imageRows());
+	for(int b=0; b<blocks.size(); b++) {
+		emit scanLines(blocks[b]);
 	}
+	finishRedraw();
 }
 
 void FaxReceiver::skip(void)
 {
 	if(state==APTSTART) {
-		lpm=lpmSum=0;
+		lpm=0;
 		state=PHASING;
-		phaseHigh = currentValue>=128 ? true : false;
-		currPhaseLength=currPhaseHigh=0;
-		phaseLines=noPhaseLines=0;
+		phasing.init(sampleRate,phaseInvers);
 		emit startingPhasing();
 	} else if(state==PHASING) {
 		lpm=txLPM;
 		state=IMAGE;
+		origin=sampleCount;
+		addEvent(FaxSession::IMAGE,0);
 		emit imageStarts();
-		double pos=std::fmod(imageSample,sampleRate*60/lpm);
-		pos/=sampleRate*60.0/lpm;
-		lastCol=static_cast<int>(pos*width);
-		pixel=pixelSamples=imageSample=0;
+		imageSample=0;
+		setupLine();
 		lastRow=99; // just !=0 which is the first row
 	}
 }
 
-// Here we want to remove the last detected phasing line and the following
-// non phasing line from the beginning of the image and one second of apt stop
-// from the end
+// A reception ends only once, the rest of the stop tone, the end of the
+// file or the stop button must not cut off more rows.
 
 void FaxReceiver::endReception(void)
 {
-	int h=lastRow-static_cast<int>(lpm/60.0)-1;
-	rawData.resize(imageSample);
+	if(state==DONE) {
+		return;
+	}
+	finishReception();
+}
+
+// Here we want to remove the last detected phasing line and the following
+// non phasing line from the beginning of the image and the apt stop tone
+// from the end, one second if it was not detected. A redraw ends this way
+// too, after the image got its new size.
+
+void FaxReceiver::finishReception(void)
+{
+	flushLines();
+	int h=lastRow-static_cast<int>(aptTail*lpm/60.0)-1;
+	rawData.truncate(imageSample);
 	if(h>0) {
 		emit newSize(0,2,0,color ? h/3 : h);
 		emit bufferNotEmpty(true);
@@ -244,7 +467,9 @@ void FaxReceiver::endReception(void)
 
 void FaxReceiver::releaseBuffer(void)
 {
-	rawData.resize(0);
+	cancelRedraw();
+	rawData.release();
+	session.close();
 	emit bufferNotEmpty(false);
 }
 
@@ -256,19 +481,93 @@ void FaxReceiver::setColor(bool b)
 void FaxReceiver::setAptStartFreq(int f)
 {
 	aptStartFreq=f;
+	setupApt();
 }
 
 void FaxReceiver::setAptStopFreq(int f)
 {
 	aptStopFreq=f;
+	setupApt();
 }
 
+// The image window tells the width every time the image grows, so most
+// calls change nothing.
+
 void FaxReceiver::setWidth(int width)
 {
+	if(width==this->width) {
+		return;
+	}
 	this->width=width;
+	updateLine();
 }
 
 void FaxReceiver::setPhasePol(bool pol)
 {
 	phaseInvers=pol;
 }
+
+void FaxReceiver::setKernel(int k)
+{
+	if(k==kernel) {
+		return;
+	}
+	kernel=k;
+	updateLine();
+}
+
+double FaxReceiver::eventTime(FaxSession::EventType type) const
+{
+	for(int i=0; i<events.size(); i++) {
+		if(events[i].type==type && sampleRate>0) {
+			return static_cast<double>(events[i].sample)/sampleRate;
+		}
+	}
+	return -1;
+}
+
+void FaxReceiver::addEvent(FaxSession::EventType type, int value)
+{
+	FaxSession::Event e;
+	e.sample=sampleCount;
+	e.type=type;
+	e.value=value;
+	events.append(e);
+}
+
+// A session of its own, the current one may be mapped from the file that
+// gets written.
+
+bool FaxReceiver::saveSession(const QString& fileName)
+{
+	FaxSession s;
+	s.sampleRate=sampleRate;
+	s.lpm=lpm;
+	s.width=width;
+	s.color=color;
+	s.phaseInvert=phaseInvers;
+	s.origin=origin;
+	s.events=events;
+	return s.save(fileName,rawData);
+}
+
+bool FaxReceiver::loadSession(const QString& fileName)
+{
+	cancelRedraw();
+	rawData.release();
+	if(!session.open(fileName)) {
+		emit bufferNotEmpty(false);
+		return false;
+	}
+	rawData.attach(session.samples(),session.size());
+	sampleRate=session.sampleRate;
+	lpm=session.lpm;
+	width=session.width;
+	color=session.color;
+	phaseInvers=session.phaseInvert;
+	origin=session.origin;
+	events=session.events;
+	state=DONE;
+	emit bufferNotEmpty(!rawData.isEmpty());
+	return true;
+}
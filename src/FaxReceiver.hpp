@@ -19,52 +19,114 @@
 #ifndef FAXRECEIVER_HPP
 #define FAXRECEIVER_HPP
 
+#include <QByteArray>
 #include <QObject>
 #include <QString>
-#include <QTimer>
+#include <QThreadPool>
 #include <QVector>
+#include <vector>
+#include "AptDetector.hpp"
+#include "FaxParameters.hpp"
+#include "FaxSession.hpp"
+#include "ImageRenderer.hpp"
+#include "LineResampler.hpp"
+#include "PhasingDetector.hpp"
+#include "SampleStore.hpp"
+#include "SlantTracker.hpp"
+#include "ScanLine.hpp"
 
 class FaxReceiver : public QObject {
 	Q_OBJECT
 public:
 	FaxReceiver(QObject* parent);
-	void init(int sampleRate);
+
+	/**
+	 * Get ready for a new reception.
+	 *
+	 * \param sampleRate is the rate of the demodulated signal
+	 * \param p holds the APT, phasing and fax settings
+	 */
+	void init(int sampleRate, const FaxParameters& p);
+
+	/**
+	 * Draw the stored image again at once, without going through the
+	 * event loop, e.g. after loadSession(). The rows are drawn by the
+	 * threads of the redraw pool like in correctLPM().
+	 *
+	 * \param lpm replaces the LPM of the image if it is not 0
+	 */
+	void redraw(double lpm=0);
+
+	/**
+	 * Seconds from the start of the reception to the first event of the
+	 * type, -1 if there was none.
+	 */
+	double eventTime(FaxSession::EventType type) const;
 private:
+	void addEvent(FaxSession::EventType type, int value);
 	void decodeApt(const int& x);
+	void setupApt(void);
 	void decodePhasing(const int& x);
 	void decodeImage(const int& x);
+	int rowStart(int row) const;
+	void setupLine(void);
+	void updateLine(void);
+	void trackSlant(void);
+	void drawLine(void);
+	void flushLines(void);
+	void startRedraw(void);
+	void cancelRedraw(void);
+	void finishRedraw(void);
+	void finishReception(void);
 	enum { APTSTART, PHASING, IMAGE, DONE } state;
 	int sampleRate;
-	int currentValue;
-	bool aptHigh;
-	int aptTrans;    // APT low-high transitions
-	int aptCount;    // samples counted for aptTrans
+	AptDetector apt;
+	int aptFreq;     // tone of the last block
+	int aptBlocks;   // blocks since aptFound() was emitted
+	double aptDwell; // seconds a tone must last
+	double aptTail;  // seconds cut off the end of the image
 	int aptStartFreq;
 	int aptStopFreq;
-	bool aptStop;
-	bool phaseHigh;
-	int currPhaseLength;
-	int currPhaseHigh;
-	int phaseLines;
-	int noPhaseLines;
+	PhasingDetector phasing;
 	bool phaseInvers;
 	double lpm;
 	int txLPM;
-	double lpmSum;
 	int width;
 	int imageSample;
-	int lastCol;
 	int lastRow;
-	int pixel;
-	int pixelSamples;
 	bool color;
-	QTimer* timer;
-	QVector<unsigned char> rawData;
-	QVector<unsigned char>::Iterator rawIt;
+	int kernel;
+	bool slantTracking;
+	SlantTracker slant;
+	int rowBase;                 // row and sample of the last LPM
+	int sampleBase;              // change
+	double nextSamplesPerLine;   // taken at the next row, 0 for none
+	double samplesPerLine;
+	LineResampler resampler;
+	std::vector<int> rowSamples; // samples of the current row so far
+	int lineRow;                 // current row
+	int lineCols;                // pixels of it drawn so far
+	QByteArray linePixels;
+	SampleStore rawData;
+	FaxSession session;
+	QVector<FaxSession::Event> events;
+	qint64 sampleCount;
+	qint64 origin;
+	ScanLines lines;
+	ImageRenderer renderer;
+	int redrawPending;     // blocks of rows not drawn yet
+	int redrawGeneration;  // tells rows of an older redraw apart
+	QThreadPool redrawPool; // last, waits for its threads first
 signals:
-	void aptFound(int);
+
+	/**
+	 * The APT tone of the last blocks, 0 for none, with a confidence
+	 * from 0 to 1.
+	 */
+	void aptFound(int f, double confidence);
+
 	void aptStopDetected(void);
-	void setPixel(int, int, int, int);
+	void scanLines(const ScanLines& lines);
 	void startReception(void);
 	void end(void);
 	void startingPhasing(void);
@@ -81,14 +143,42 @@ public slots:
 	void setAptStopFreq(int f);
 	void setWidth(int width);
 	void setPhasePol(bool pol);
+
+	/**
+	 * Select the LineResampler::Kernel for the next rows and redraws.
+	 */
+	void setKernel(int k);
+
 	void skip(void);
 	void endReception(void);
 	void setColor(bool b);
+
+	/**
+	 * Draw the stored image again with the LPM changed by the factor
+	 * 1+d. The rows are drawn in parallel and handed out in blocks as
+	 * soon as they are ready, end() is emitted after the last one.
+	 */
 	void correctLPM(double d);
+
+	/**
+	 * Draw the stored image again with w pixels per line, like
+	 * correctLPM().
+	 */
 	void correctWidth(int w);
 	void releaseBuffer(void);
+
+	/**
+	 * Write the last image with its samples to a session file.
+	 */
+	bool saveSession(const QString& fileName);
+
+	/**
+	 * Take the image from a session file instead. Use correctLPM(0) or
+	 * redraw() to draw it.
+	 */
+	bool loadSession(const QString& fileName);
 private slots:
-        void adjustNext(void);
+	void rowsDrawn(const ScanLines& lines, int generation);
 };
 
 #endif
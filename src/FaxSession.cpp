@@ -0,0 +1,129 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "FaxSession.hpp"
+#include "SampleStore.hpp"
+#include <QDataStream>
+#include <QSaveFile>
+#include <vector>
+
+static const quint32 magic=0x48465853; // "HFXS"
+static const quint32 version=1;
+
+FaxSession::FaxSession(void)
+	: sampleRate(0), lpm(0), width(0), color(false), phaseInvert(false),
+	  origin(0), data(0), count(0)
+{
+}
+
+bool FaxSession::save(const QString& fileName, const SampleStore& samples)
+{
+	// truncating the file in place would take away the samples if
+	// they are mapped from it
+	QSaveFile out(fileName);
+	if(!out.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	QDataStream s(&out);
+	s.setVersion(QDataStream::Qt_5_0);
+	s<<magic<<version<<qint32(sampleRate)<<lpm<<qint32(width)
+	 <<color<<phaseInvert<<origin<<quint32(events.size());
+	for(int i=0; i<events.size(); i++) {
+		s<<events[i].sample<<events[i].type<<events[i].value;
+	}
+	s<<quint64(samples.size());
+	if(s.status()!=QDataStream::Ok) {
+		return false;
+	}
+	std::vector<char> buffer(65536);
+	for(size_t i=0; i<samples.size(); ) {
+		size_t n=0;
+		while(n<buffer.size() && i<samples.size()) {
+			buffer[n++]=samples.at(i++);
+		}
+		if(out.write(&buffer[0],n)!=static_cast<qint64>(n)) {
+			return false;
+		}
+	}
+	return out.commit();
+}
+
+bool FaxSession::open(const QString& fileName)
+{
+	close();
+	file.setFileName(fileName);
+	if(!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+	QDataStream s(&file);
+	s.setVersion(QDataStream::Qt_5_0);
+	quint32 m, v, n;
+	qint32 rate, w;
+	s>>m>>v;
+	if(m!=magic || v!=version) {
+		file.close();
+		return false;
+	}
+	s>>rate>>lpm>>w>>color>>phaseInvert>>origin>>n;
+	sampleRate=rate;
+	width=w;
+	events.resize(0);
+	for(quint32 i=0; i<n && s.status()==QDataStream::Ok; i++) {
+		Event e;
+		s>>e.sample>>e.type>>e.value;
+		events.append(e);
+	}
+	quint64 samplesSize;
+	s>>samplesSize;
+	qint64 offset=file.pos();
+	if(s.status()!=QDataStream::Ok
+	   || offset+static_cast<qint64>(samplesSize)>file.size()) {
+		file.close();
+		return false;
+	}
+	count=samplesSize;
+	data=count>0 ? file.map(offset,count) : 0;
+	if(count>0 && !data) {
+		count=0;
+		file.close();
+		return false;
+	}
+	return true;
+}
+
+void FaxSession::close(void)
+{
+	if(data) {
+		file.unmap(data);
+		data=0;
+	}
+	count=0;
+	if(file.isOpen()) {
+		file.close();
+	}
+}
+
+const unsigned char* FaxSession::samples(void) const
+{
+	return data;
+}
+
+size_t FaxSession::size(void) const
+{
+	return count;
+}
@@ -0,0 +1,99 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef FAXSESSION_HPP
+#define FAXSESSION_HPP
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+class SampleStore;
+
+/**
+ * A reception saved to a file, so that the image can be drawn again with
+ * other LPM or width settings long after the reception.
+ *
+ * The file holds a header with the settings of the reception and the
+ * events seen by the receiver, written with QDataStream, followed by the
+ * demodulated samples of the image, one byte per sample. An opened
+ * session maps the samples into memory instead of reading them, so even
+ * a long chart opens at once and takes no memory of its own.
+ */
+
+class FaxSession {
+public:
+	enum EventType { APT, PHASING, IMAGE };
+
+	/**
+	 * Something the receiver found in the demodulated signal.
+	 */
+	struct Event {
+		qint64 sample;    // position in the demodulated signal
+		qint32 type;      // EventType
+		qint32 value;     // APT frequency, LPM of a phasing line or 0
+	};
+
+	FaxSession(void);
+
+	/**
+	 * Write a session file. The file is written under another name
+	 * and renamed at the end, so the samples may come from the mapping
+	 * of the same file opened before.
+	 *
+	 * \param fileName is the name of the file
+	 * \param samples holds the demodulated samples of the image
+	 * \return false if the file could not be written
+	 */
+	bool save(const QString& fileName, const SampleStore& samples);
+
+	/**
+	 * Read the header of a session file and map its samples.
+	 *
+	 * \return false if the file could not be opened or is no session
+	 */
+	bool open(const QString& fileName);
+
+	/**
+	 * Unmap the samples of an opened session.
+	 */
+	void close(void);
+
+	/**
+	 * The samples of an opened session, valid until close().
+	 */
+	const unsigned char* samples(void) const;
+	size_t size(void) const;
+
+	int sampleRate;          // rate of the demodulated signal
+	double lpm;              // LPM the image was drawn with
+	int width;               // pixels per line
+	bool color;              // color facsimile
+	bool phaseInvert;        // inverted phasing lines
+	qint64 origin;           // position of the first image sample in
+	                         // the demodulated signal
+	QVector<Event> events;
+private:
+	FaxSession(const FaxSession&);
+	FaxSession& operator=(const FaxSession&);
+	QFile file;
+	uchar* data;
+	size_t count;
+};
+
+#endif
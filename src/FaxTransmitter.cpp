@@ -16,26 +16,46 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
-#include "Config.hpp"
 #include "FaxTransmitter.hpp"
 #include <cmath>
 
-FaxTransmitter::FaxTransmitter(QObject* parent, FaxImage* faxImage)
-	: QObject(parent), image(faxImage)
+FaxTransmitter::FaxTransmitter(QObject* parent)
+	: QObject(parent), cols(0), rows(0)
 {
 }
 
-void FaxTransmitter::start(int sampleRate)
+void FaxTransmitter::setImage(const QImage& image)
 {
-	Config& config=Config::instance();
-	startLength=config.readNumEntry("/hamfax/APT/startLength");
-	startFreq=config.readNumEntry("/hamfax/APT/startFrequency");
-	stopLength=config.readNumEntry("/hamfax/APT/stopLength");
-	stopFreq=config.readNumEntry("/hamfax/APT/stopFrequency");
-	lpm=config.readNumEntry("/hamfax/fax/LPM");
-	phasingLines=config.readNumEntry("/hamfax/phasing/lines");
-	phaseInvers=config.readBoolEntry("/hamfax/phasing/invert");
-	color=config.readBoolEntry("/hamfax/fax/color");
+	this->image=image;
+	cols=image.width();
+	rows=image.height();
+}
+
+int FaxTransmitter::getPixel(int col, int row, int rgbg)
+{
+	QRgb pixel=image.pixel(col,row);
+	switch(rgbg) {
+	case 0:
+		return qRed(pixel);
+	case 1:
+		return qGreen(pixel);
+	case 2:
+		return qBlue(pixel);
+	default:
+		return qGray(pixel);
+	};
+}
+
+void FaxTransmitter::start(int sampleRate, const FaxParameters& p)
+{
+	startLength=p.aptStartLength;
+	startFreq=p.aptStartFrequency;
+	stopLength=p.aptStopLength;
+	stopFreq=p.aptStopFrequency;
+	lpm=p.lpm;
+	phasingLines=p.phasingLines;
+	phaseInvers=p.phaseInvert;
+	color=p.color;
 	this->sampleRate=sampleRate;
 	state=APTSTART;
 	sampleNr=0;
@@ -91,8 +111,8 @@ void FaxTransmitter::doNext(int n)
 				if(row!=r) {
 					emit imageLine((row=r)/(color?3:1));
 				}
-				buf[i]=image->getPixel(c, color? r/3:r,
-						       color? r%3:3)/255.0;
+				buf[i]=getPixel(c, color? r/3:r,
+						color? r%3:3)/255.0;
 				sampleNr++;
 			} else {
 				state=APTSTOP;
@@ -119,12 +139,6 @@ void FaxTransmitter::doNext(int n)
 	emit data(buf,n);
 }
 
-void FaxTransmitter::setImageSize(int cols, int rows)
-{
-	this->rows=rows;
-	this->cols=cols;
-}
-
 void FaxTransmitter::doAptStop(void)
 {
 	state=APTSTOP;
@@ -20,15 +20,30 @@
 #define FAXTRANSMITTER_HPP
 
 #include <qobject.h>
-#include "FaxImage.hpp"
+#include <qimage.h>
+#include "FaxParameters.hpp"
 
 class FaxTransmitter : public QObject {
 	Q_OBJECT
 public:
-	FaxTransmitter(QObject* parent, FaxImage* faxImage);
-	void start(int sampleRate);
+	FaxTransmitter(QObject* parent);
+
+	/**
+	 * Set the image for the next transmission. The image is shared, not
+	 * copied, as long as nobody changes it.
+	 */
+	void setImage(const QImage& image);
+
+	/**
+	 * Start a transmission of the image.
+	 *
+	 * \param sampleRate is the rate of the samples to create
+	 * \param p holds the APT, phasing and fax settings
+	 */
+	void start(int sampleRate, const FaxParameters& p);
 private:
-	FaxImage* image;
+	int getPixel(int col, int row, int rgbg);
+	QImage image;
 	enum { APTSTART, PHASING, ENDPHASING, IMAGE, APTSTOP, IDLE } state;
 	int sampleNr;
 	int sampleRate;
@@ -46,7 +61,6 @@ private:
 	int cols;
 	int rows;
 public slots:
-	void setImageSize(int cols, int rows);
 	void doNext(int n);
 	void doAptStop(void);
 signals:
@@ -21,6 +21,11 @@
 #include "Error.hpp"
 #include "HelpDialog.hpp"
 #include "OptionsDialog.hpp"
+#include "TimeStamp.hpp"
+#include "config.h"
+#ifdef USE_STATS
+#include "StatsDialog.hpp"
+#endif
 #include <qapplication.h>
 #include <QFileDialog>
 #include <qstring.h>
@@ -46,13 +51,14 @@ FaxWindow::FaxWindow(const QString& version)
 
 	// create child objects
 	setCentralWidget(faxImage=new FaxImage(this));
-	faxReceiver=new FaxReceiver(this);
-	faxTransmitter=new FaxTransmitter(this,faxImage);
+	pipeline=new ReceptionPipeline;
+	faxReceiver=pipeline->receiver();
+	faxDemodulator=pipeline->demodulator();
+	faxTransmitter=new FaxTransmitter(this);
 	file=new File(this);
 	ptc=new PTC(this);
 	sound=new Sound(this);
 	faxModulator=new FaxModulator(this);
-	faxDemodulator=new FaxDemodulator(this);
 	transmitDialog=new TransmitDialog(this);
 	receiveDialog=new ReceiveDialog(this);
 	correctDialog=new CorrectDialog(this);
@@ -67,11 +73,9 @@ FaxWindow::FaxWindow(const QString& version)
 		SLOT(newImageSize(int, int)));
 	connect(faxImage,SIGNAL(sizeUpdated(int,int)),
 		faxReceiver,SLOT(setWidth(int)));
-	connect(faxImage,SIGNAL(sizeUpdated(int,int)),
-		faxTransmitter,SLOT(setImageSize(int,int)));
 
-	connect(faxReceiver,SIGNAL(setPixel(int, int, int, int)),
-		faxImage,SLOT(setPixel(int, int, int,int)));
+	connect(faxReceiver,SIGNAL(scanLines(const ScanLines&)),
+		faxImage,SLOT(setScanLines(const ScanLines&)));
 	connect(faxReceiver, SIGNAL(newSize(int, int, int, int)),
 		faxImage, SLOT(resize(int, int, int, int)));
 
@@ -96,16 +100,14 @@ FaxWindow::FaxWindow(const QString& version)
 	connect(receiveDialog,SIGNAL(skipClicked()),faxReceiver,SLOT(skip()));
 	connect(receiveDialog,SIGNAL(cancelClicked()),
 		faxReceiver,SLOT(endReception()));
-	connect(sound, SIGNAL(data(short*,int)),
-		receiveDialog, SLOT(samples(short*,int)));
-	connect(file, SIGNAL(data(short*,int)),
-		receiveDialog,SLOT(samples(short*,int)));
-	connect(faxDemodulator, SIGNAL(data(int*,int)),
-		receiveDialog, SLOT(imageData(int*,int)));
+	connect(pipeline, SIGNAL(samples(const QVector<short>&)),
+		receiveDialog, SLOT(samples(const QVector<short>&)));
+	connect(pipeline, SIGNAL(imageData(const QVector<int>&)),
+		receiveDialog, SLOT(imageData(const QVector<int>&)));
 	connect(ptc,SIGNAL(data(int*,int)),
 		receiveDialog, SLOT(imageData(int*,int)));
-	connect(faxReceiver,SIGNAL(aptFound(int)),
-		receiveDialog,SLOT(apt(int)));
+	connect(faxReceiver,SIGNAL(aptFound(int,double)),
+		receiveDialog,SLOT(apt(int,double)));
 	connect(faxReceiver,SIGNAL(startingPhasing()),
 		receiveDialog,SLOT(phasing()));
 	connect(faxReceiver,SIGNAL(phasingLine(double)),
@@ -136,6 +138,11 @@ FaxWindow::FaxWindow(const QString& version)
 	restoreState(Config::instance().value("GUI/windowState").toByteArray());
 }
 
+FaxWindow::~FaxWindow(void)
+{
+	delete pipeline;
+}
+
 void FaxWindow::createMenubar(void)
 {
 	Config& config=Config::instance();
@@ -146,6 +153,10 @@ void FaxWindow::createMenubar(void)
 	fileMenu->addAction(tr("&Save"), this, SLOT(save()));
 	fileMenu->addAction(tr("&Quick save as PNG"), this, SLOT(quickSave()));
 	fileMenu->addSeparator();
+	fileMenu->addAction(tr("Open s&ession"), this, SLOT(openSession()));
+	saveSessionAction = fileMenu->addAction(tr("Save sess&ion"),
+						this, SLOT(saveSession()));
+	fileMenu->addSeparator();
 	fileMenu->addAction(tr("&Exit"), this, SLOT(close()));
 
 	QMenu* transmitMenu = new QMenu(tr("&Transmit"));
@@ -216,6 +227,10 @@ void FaxWindow::createMenubar(void)
 	menuBar()->addSeparator();
 	menuBar()->addMenu(helpMenu);
 	helpMenu->addAction(tr("&Help"), this, SLOT(help()));
+#ifdef USE_STATS
+	helpMenu->addAction(tr("receive &statistics"),
+			    new StatsDialog(this), SLOT(show()));
+#endif
 	helpMenu->addSeparator();
 	helpMenu->addAction(tr("&About hamfax"), this, SLOT(about()));
 	helpMenu->addAction(tr("About &QT"), this, SLOT(aboutQT()));
@@ -453,25 +468,20 @@ void FaxWindow::endTransmission(void)
 
 void FaxWindow::endReception(void)
 {
+	// the pipeline must not read from the device any more
+	QMetaObject::invokeMethod(pipeline,"stop",
+				  Qt::BlockingQueuedConnection);
 	switch(interface) {
 	case FILE:
 		file->end();
-		disconnect(file, SIGNAL(data(short*, int)),
-			faxDemodulator, SLOT(newSamples(short*, int)));
-		disconnect(faxDemodulator, SIGNAL(data(int*, int)),
-			faxReceiver, SLOT(decode(int*, int)));
 		break;
 	case DSP:
 		sound->end();
-		disconnect(sound, SIGNAL(data(short*, int)),
-			faxDemodulator,	SLOT(newSamples(short*, int)));
-		disconnect(faxDemodulator, SIGNAL(data(int*, int)),
-			faxReceiver, SLOT(decode(int*, int)));
 		break;
 	case SCSPTC:
 		ptc->end();
 		disconnect(ptc,SIGNAL(data(int*, int)),
-			   faxReceiver, SLOT(decode(int*, int)));
+			   pipeline, SLOT(ptcData(int*, int)));
 		break;
 	}
 }
@@ -531,6 +541,7 @@ void FaxWindow::enableControls(void)
 
 void FaxWindow::setImageAdjust(bool b)
 {
+	saveSessionAction->setEnabled(b);
 	slantAction->setEnabled(b);
 	colorDrawAction->setEnabled(b);
 	monoDrawAction->setEnabled(b);
@@ -586,21 +597,67 @@ void FaxWindow::save(void)
 
 void FaxWindow::quickSave(void)
 {
-	QDateTime dt=QDateTime::currentDateTime();
-	QDate date=dt.date();
-	QTime time=dt.time();
-	QString name;
-	name.sprintf("%04d-%02d-%02d-%02d-%02d-%02d.png",
-		     date.year(),date.month(),date.day(),
-		     time.hour(),time.minute(),time.second());
-	faxImage->save(name);
+	faxImage->save(timeStampName(QDateTime::currentDateTime(),".png"));
+}
+
+// A new image of the session's width, the receiver fills it with the
+// redraw. The blocking call makes sure that the receiver got the new size
+// before it draws.
+
+void FaxWindow::openSession(void)
+{
+	QString name=QFileDialog::getOpenFileName(this, windowTitle(), ".",
+						  "*.hfs");
+	if(name.isEmpty()) {
+		return;
+	}
+	FaxSession session;
+	bool ok=session.open(name);
+	if(ok) {
+		faxImage->create(session.width,50);
+		session.close();
+		QMetaObject::invokeMethod(faxReceiver,"loadSession",
+					  Qt::BlockingQueuedConnection,
+					  Q_RETURN_ARG(bool,ok),
+					  Q_ARG(QString,name));
+	}
+	if(ok) {
+		QMetaObject::invokeMethod(faxReceiver,"correctLPM",
+					  Q_ARG(double,0));
+	} else {
+		QMessageBox::warning(this, windowTitle(),
+			tr("'%1' is no session file.").arg(name));
+	}
+}
+
+void FaxWindow::saveSession(void)
+{
+	QString name=QFileDialog::getSaveFileName(this, windowTitle(), ".",
+						  "*.hfs");
+	if(name.isEmpty()) {
+		return;
+	}
+	if(!name.endsWith(".hfs")) {
+		name.append(".hfs");
+	}
+	bool ok=false;
+	QMetaObject::invokeMethod(faxReceiver,"saveSession",
+				  Qt::BlockingQueuedConnection,
+				  Q_RETURN_ARG(bool,ok),
+				  Q_ARG(QString,name));
+	if(!ok) {
+		QMessageBox::warning(this, windowTitle(),
+			tr("Could not save to file '%1'.").arg(name));
+	}
 }
 
 void FaxWindow::initTransmitCommon(int interface, int sampleRate)
 {
 	this->interface = interface;
-	faxTransmitter->start(sampleRate);
-	faxModulator->init(sampleRate);
+	FaxParameters p=Config::instance().faxParameters();
+	faxTransmitter->setImage(faxImage->getImage());
+	faxTransmitter->start(sampleRate,p);
+	faxModulator->init(sampleRate,p);
 	transmitDialog->start();
 	disableControls();
 }
@@ -663,10 +720,12 @@ void FaxWindow::initTransmitPtc()
 void FaxWindow::initReceptionCommon(int interface, int sampleRate)
 {
 	this->interface = interface;
-	faxReceiver->init(sampleRate);
+	pipeline->setParameters(Config::instance().faxParameters());
+	QMetaObject::invokeMethod(pipeline,"start",
+				  Qt::BlockingQueuedConnection,
+				  Q_ARG(int,sampleRate));
 	receiveDialog->aptStart();
 	disableControls();
-	faxDemodulator->init(sampleRate);
 }
 
 void FaxWindow::initReceptionFile()
@@ -678,10 +737,7 @@ void FaxWindow::initReceptionFile()
 		if(fileName.isEmpty())
 			return;
 		int sampleRate=file->startInput(fileName);
-		connect(file, SIGNAL(data(short*,int)),
-			faxDemodulator, SLOT(newSamples(short*,int)));
-		connect(faxDemodulator, SIGNAL(data(int*,int)),
-			faxReceiver, SLOT(decode(int*,int)));
+		pipeline->setSource(file);
 
 		initReceptionCommon(FILE, sampleRate);
 	} catch (Error e) {
@@ -693,10 +749,7 @@ void FaxWindow::initReceptionDsp()
 {
 	try {
 		int sampleRate=sound->startInput();
-		connect(sound,SIGNAL(data(short*,int)),
-			faxDemodulator, SLOT(newSamples(short*,int)));
-		connect(faxDemodulator, SIGNAL(data(int*,int)),
-			faxReceiver, SLOT(decode(int*,int)));
+		pipeline->setSource(&sound->captureBuffer());
 
 		initReceptionCommon(DSP, sampleRate);
 	} catch (Error e) {
@@ -708,8 +761,10 @@ void FaxWindow::initReceptionPtc()
 {
         try {
 		int sampleRate=ptc->startInput();
+		pipeline->setSource();
 		connect(ptc,SIGNAL(data(int*,int)),
-			faxReceiver, SLOT(decode(int*, int)));
+			pipeline, SLOT(ptcData(int*, int)),
+			Qt::DirectConnection);
 
 		initReceptionCommon(SCSPTC, sampleRate);
 	} catch(Error e) {
@@ -724,7 +779,8 @@ void FaxWindow::adjustIOC(void)
 					      tr("Please enter IOC"), ioc,
 					      204, 576, 1, &ok);
 	if(ok) {
-		faxReceiver->correctWidth(M_PI*iocNew);
+		QMetaObject::invokeMethod(faxReceiver,"correctWidth",
+					  Q_ARG(int,static_cast<int>(M_PI*iocNew)));
 	}
 }
 
@@ -749,16 +805,16 @@ void FaxWindow::slantWaitFirst(void)
 
 void FaxWindow::redrawColor(void)
 {
-	Config::instance().writeEntry("/hamfax/fax/color",true);
 	colorBox->setCurrentIndex(1);
-	faxReceiver->correctLPM(0);
+	setColor(1);
+	QMetaObject::invokeMethod(faxReceiver,"correctLPM",Q_ARG(double,0));
 }
 
 void FaxWindow::redrawMono(void)
 {
-	Config::instance().writeEntry("/hamfax/fax/color",false);
 	colorBox->setCurrentIndex(0);
-	faxReceiver->correctLPM(0);
+	setColor(0);
+	QMetaObject::invokeMethod(faxReceiver,"correctLPM",Q_ARG(double,0));
 }
 
 void FaxWindow::setBegin(void)
@@ -774,6 +830,9 @@ void FaxWindow::doOptions(void)
 	OptionsDialog* o=new OptionsDialog(this);
 	o->exec();
 	delete o;
+	// the next rows and redraws use the new kernel
+	QMetaObject::invokeMethod(faxReceiver,"setKernel",Q_ARG(int,
+		Config::instance().faxParameters().kernel));
 }
 
 void FaxWindow::selectFont(void)
@@ -887,4 +946,7 @@ void FaxWindow::setPhaseInvert(int i)
 void FaxWindow::setColor(int c)
 {
 	Config::instance().writeEntry("/hamfax/fax/color",c==1);
+	// for redrawing the last image, the controls are disabled while
+	// receiving
+	QMetaObject::invokeMethod(faxReceiver,"setColor",Q_ARG(bool,c==1));
 }
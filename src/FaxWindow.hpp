@@ -35,6 +35,7 @@
 #include "File.hpp"
 #include "PTC.hpp"
 #include "ReceiveDialog.hpp"
+#include "ReceptionPipeline.hpp"
 #include "Sound.hpp"
 #include "ToolTipFilter.hpp"
 #include "TransmitDialog.hpp"
@@ -43,9 +44,11 @@ class FaxWindow : public QMainWindow {
 	Q_OBJECT
 public:
 	FaxWindow(const QString& version);
+	~FaxWindow(void);
 private:
 	// menus
 	void createMenubar();
+	QAction* saveSessionAction;
 	QAction* slantAction;
 	QAction* colorDrawAction;
 	QAction* monoDrawAction;
@@ -72,6 +75,7 @@ private:
 	FaxImage* faxImage;
 	FaxReceiver* faxReceiver;
 	FaxTransmitter* faxTransmitter;
+	ReceptionPipeline* pipeline;
 	PTC* ptc;
 	Sound* sound;
 	CorrectDialog* correctDialog;
@@ -109,6 +113,8 @@ private slots:
         void load(void);
         void save(void);
 	void quickSave(void);
+	void openSession(void);
+	void saveSession(void);
 
 	// Transmit and Receive
 	void initTransmitFile(void);
@@ -83,8 +83,6 @@ int File::startInput(const QString& fileName)
 		if(afGetRate(aFile,AF_DEFAULT_TRACK)!=8000) {
 			throw Error(tr("sample rate is not 8000 Hz"));
 		}
-		timer->start(0);
-		connect(timer,SIGNAL(timeout()),this,SLOT(read()));
 	} catch(Error) {
 		end();
 		throw;
@@ -113,12 +111,13 @@ void File::write(short* samples, int number)
 	}
 }
 
-void File::read(void)
+int File::read(short* buffer, int n)
 {
-	int n=blockSize;
-	short buffer[n];
+	if(aFile==0) {
+		return 0;
+	}
 	n=afReadFrames(aFile,AF_DEFAULT_TRACK,buffer,n);
-	emit data(buffer,n);
+	return n>0 ? n : 0;
 }
 
 void File::timerSignal(void)
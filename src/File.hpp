@@ -30,20 +30,26 @@ public:
 	~File(void);
 	int startOutput(const QString& fileName);
 	int startInput(const QString& fileName);
+
+	/**
+	 * Read the next samples of the file opened by startInput. The
+	 * reception reads the file from its own thread, so there is no
+	 * signal for the data.
+	 *
+	 * \return the number of samples read, 0 at the end of the file
+	 */
+	int read(short* buffer, int n);
 	void end(void);
 private:
 	static const int blockSize=512;
 	AFfilehandle aFile;
 	QTimer* timer;
 signals:
-	void data(short* buffer, int n);
 	void next(int n);
 	void deviceClosed(void);
 public slots:
 	void write(short* samples, int number);
 	void timerSignal(void);
-private slots:
-        void read(void);
 };
 
 #endif
@@ -19,11 +19,19 @@
 #ifndef FIRFILTER_HPP
 #define FIRFILTER_HPP
 
+#include <algorithm>
 #include <valarray>
+#include "FirKernels.hpp"
 
 /**
  * This template class implements a FIR filter (finite impulse response). 
  * The template parameter defines the type of input and output data.
+ *
+ * The delay line is kept linear: the last size()-1 samples are followed
+ * by room for a block of new samples. A whole block is then convolved in
+ * one go, without the wrap around of a ring buffer, and afterwards the
+ * newest samples are moved to the front again. For double samples the
+ * convolution is done by the vector kernels in FirKernels.
  */
 
 template <class T> class FirFilter {
@@ -43,8 +51,7 @@ public:
 
 	/**
 	 * Set new buffer content, e.g. all zero.
-	 * \param b is the new buffer content;, the size has to be the same
-	 * as the old!
+	 * \param b are the last size()-1 samples, oldest first
 	 */
 	void setBuffer(const std::valarray<T>& b);
 
@@ -59,19 +66,32 @@ public:
 	T filterSample(const T& sample);
 
 	/**
-	 * Get current buffer; useful for debugging purposes.
+	 * Pass a block of samples through the filter.
+	 * \param in points to n input samples
+	 * \param out receives the n filtered samples; it may be the same
+	 * array as in
+	 * \param n is the number of samples
+	 */
+	void filterBlock(const T* in, T* out, size_t n);
+
+	/**
+	 * Get the last size()-1 samples, oldest first; useful for debugging
+	 * purposes.
 	 */
 	std::valarray<T> getBuffer() const;
 private:
+	static const size_t blockSize=512;
+	static void convolve(const T* x, const T* c, size_t taps,
+			     T* out, size_t n);
         std::valarray<T> coeffs;
         std::valarray<T> buffer;
-        T* current;
 };
 
+template <class T> const size_t FirFilter<T>::blockSize;
+
 template <class T> FirFilter<T>::FirFilter(size_t n)
-	: coeffs(n), buffer(n)
+	: coeffs(n), buffer(n-1+blockSize)
 {
-	current=&buffer[0];
 }
 
 template <class T> void FirFilter<T>::setCoeffs(const std::valarray<T>& c)
@@ -81,42 +101,65 @@ template <class T> void FirFilter<T>::setCoeffs(const std::valarray<T>& c)
 
 template <class T> inline void FirFilter<T>::setBuffer(const std::valarray<T>& b)
 {
-	buffer=b;
+	std::copy(&b[0],&b[0]+size()-1,&buffer[0]);
 }
 
 template <class T> inline size_t FirFilter<T>::size() const
 {
-	return buffer.size();
+	return coeffs.size();
+}
+
+// Every output is summed in the same order as in the former ring buffer
+// implementation, newest sample times first coefficient first.
+
+template <class T> inline void FirFilter<T>::convolve(const T* x, const T* c,
+						       size_t taps,
+						       T* out, size_t n)
+{
+	for(size_t i=0; i<n; i++) {
+		T sum=0;
+		for(size_t k=0; k<taps; k++) {
+			sum+=*(x+i-k)*c[k];
+		}
+		out[i]=sum;
+	}
+}
+
+template <> inline void FirFilter<double>::convolve(const double* x,
+						    const double* c,
+						    size_t taps,
+						    double* out, size_t n)
+{
+	firBlock(x,c,taps,out,n);
 }
 
 template <class T> inline T FirFilter<T>::filterSample(const T& sample)
 {
-        const T* c=&coeffs[0];
-	T* const c_end=&coeffs[coeffs.size()];
-	T* const b_begin=&buffer[0];
-	T* const b_end=&buffer[buffer.size()];
-        T sum=0;
-
-        // replace oldest value with current
-        *current=sample;
-
-	// convolution
-	while(current!=b_end)
-		sum+=(*current++)*(*c++);
-	current=b_begin;
-	while(c!=c_end)
-		sum+=(*current++)*(*c++);
-
-        // point again to oldest value
-        if(--current<b_begin)
-                current=b_end-1;
-
-        return sum;
+	T result;
+	filterBlock(&sample,&result,1);
+	return result;
+}
+
+template <class T>
+inline void FirFilter<T>::filterBlock(const T* in, T* out, size_t n)
+{
+	const size_t history=size()-1;
+	T* const x=&buffer[history];
+	while(n>0) {
+		size_t m=std::min(n,blockSize);
+		std::copy(in,in+m,x);
+		convolve(x,&coeffs[0],size(),out,m);
+		// keep the newest samples in front of the next block
+		std::copy(x+m-history,x+m,&buffer[0]);
+		in+=m;
+		out+=m;
+		n-=m;
+	}
 }
 
 template <class T>
 inline std::valarray<T> FirFilter<T>::getBuffer(void) const
 {
-	return buffer;
+	return buffer[std::slice(0,size()-1,1)];
 }
 #endif
@@ -0,0 +1,332 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "FirKernels.hpp"
+#include <QAtomicPointer>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FIR_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define FIR_NEON
+#include <arm_neon.h>
+#endif
+
+typedef void (*FirBlockFunc)(const double*, const double*, size_t,
+			     double*, size_t);
+typedef void (*FirDecimateFunc)(const double*, const double*, size_t,
+				double*, size_t, size_t);
+
+static void firBlockScalar(const double* x, const double* c, size_t taps,
+			   double* out, size_t n)
+{
+	for(size_t i=0; i<n; i++) {
+		double sum=0;
+		for(size_t k=0; k<taps; k++) {
+			sum+=*(x+i-k)*c[k];
+		}
+		out[i]=sum;
+	}
+}
+
+static void firBlockIQScalar(const double* x, const double* c, size_t taps,
+			     double* out, size_t n)
+{
+	for(size_t i=0; i<2*n; i+=2) {
+		double isum=0;
+		double qsum=0;
+		for(size_t k=0; k<taps; k++) {
+			isum+=*(x+i-2*k)*c[k];
+			qsum+=*(x+i+1-2*k)*c[k];
+		}
+		out[i]=isum;
+		out[i+1]=qsum;
+	}
+}
+
+static void firDecimateIQScalar(const double* x, const double* c,
+				size_t taps, double* out, size_t n,
+				size_t factor)
+{
+	for(size_t j=0; j<n; j++) {
+		const double* xj=x+2*j*factor;
+		double isum=0;
+		double qsum=0;
+		for(size_t k=0; k<taps; k++) {
+			isum+=*(xj-2*k)*c[k];
+			qsum+=*(xj+1-2*k)*c[k];
+		}
+		out[2*j]=isum;
+		out[2*j+1]=qsum;
+	}
+}
+
+#ifdef FIR_X86
+__attribute__((target("sse2")))
+static void firBlockSse2(const double* x, const double* c, size_t taps,
+			 double* out, size_t n)
+{
+	size_t i=0;
+	for(; i+4<=n; i+=4) {
+		__m128d acc0=_mm_setzero_pd();
+		__m128d acc1=_mm_setzero_pd();
+		for(size_t k=0; k<taps; k++) {
+			__m128d ck=_mm_set1_pd(c[k]);
+			acc0=_mm_add_pd(acc0,
+				_mm_mul_pd(_mm_loadu_pd(x+i-k),ck));
+			acc1=_mm_add_pd(acc1,
+				_mm_mul_pd(_mm_loadu_pd(x+i+2-k),ck));
+		}
+		_mm_storeu_pd(out+i,acc0);
+		_mm_storeu_pd(out+i+2,acc1);
+	}
+	firBlockScalar(x+i,c,taps,out+i,n-i);
+}
+
+__attribute__((target("avx2")))
+static void firBlockAvx2(const double* x, const double* c, size_t taps,
+			 double* out, size_t n)
+{
+	size_t i=0;
+	for(; i+8<=n; i+=8) {
+		__m256d acc0=_mm256_setzero_pd();
+		__m256d acc1=_mm256_setzero_pd();
+		for(size_t k=0; k<taps; k++) {
+			__m256d ck=_mm256_broadcast_sd(c+k);
+			acc0=_mm256_add_pd(acc0,
+				_mm256_mul_pd(_mm256_loadu_pd(x+i-k),ck));
+			acc1=_mm256_add_pd(acc1,
+				_mm256_mul_pd(_mm256_loadu_pd(x+i+4-k),ck));
+		}
+		_mm256_storeu_pd(out+i,acc0);
+		_mm256_storeu_pd(out+i+4,acc1);
+	}
+	firBlockSse2(x+i,c,taps,out+i,n-i);
+}
+
+// One SSE2 register holds exactly one complex sample, so the coefficient
+// is simply broadcast to both lanes.
+
+__attribute__((target("sse2")))
+static void firBlockIQSse2(const double* x, const double* c, size_t taps,
+			   double* out, size_t n)
+{
+	size_t i=0;
+	for(; i+2<=n; i+=2) {
+		const double* xi=x+2*i;
+		__m128d acc0=_mm_setzero_pd();
+		__m128d acc1=_mm_setzero_pd();
+		for(size_t k=0; k<taps; k++) {
+			__m128d ck=_mm_set1_pd(c[k]);
+			acc0=_mm_add_pd(acc0,
+				_mm_mul_pd(_mm_loadu_pd(xi-2*k),ck));
+			acc1=_mm_add_pd(acc1,
+				_mm_mul_pd(_mm_loadu_pd(xi+2-2*k),ck));
+		}
+		_mm_storeu_pd(out+2*i,acc0);
+		_mm_storeu_pd(out+2*i+2,acc1);
+	}
+	firBlockIQScalar(x+2*i,c,taps,out+2*i,n-i);
+}
+
+__attribute__((target("avx2")))
+static void firBlockIQAvx2(const double* x, const double* c, size_t taps,
+			   double* out, size_t n)
+{
+	size_t i=0;
+	for(; i+4<=n; i+=4) {
+		const double* xi=x+2*i;
+		__m256d acc0=_mm256_setzero_pd();
+		__m256d acc1=_mm256_setzero_pd();
+		for(size_t k=0; k<taps; k++) {
+			__m256d ck=_mm256_broadcast_sd(c+k);
+			acc0=_mm256_add_pd(acc0,
+				_mm256_mul_pd(_mm256_loadu_pd(xi-2*k),ck));
+			acc1=_mm256_add_pd(acc1,
+				_mm256_mul_pd(_mm256_loadu_pd(xi+4-2*k),ck));
+		}
+		_mm256_storeu_pd(out+2*i,acc0);
+		_mm256_storeu_pd(out+2*i+4,acc1);
+	}
+	firBlockIQSse2(x+2*i,c,taps,out+2*i,n-i);
+}
+
+__attribute__((target("sse2")))
+static void firDecimateIQSse2(const double* x, const double* c, size_t taps,
+			      double* out, size_t n, size_t factor)
+{
+	for(size_t j=0; j<n; j++) {
+		const double* xj=x+2*j*factor;
+		__m128d acc=_mm_setzero_pd();
+		for(size_t k=0; k<taps; k++) {
+			acc=_mm_add_pd(acc,_mm_mul_pd(_mm_loadu_pd(xj-2*k),
+						      _mm_set1_pd(c[k])));
+		}
+		_mm_storeu_pd(out+2*j,acc);
+	}
+}
+#endif
+
+#ifdef FIR_NEON
+static void firBlockNeon(const double* x, const double* c, size_t taps,
+			 double* out, size_t n)
+{
+	size_t i=0;
+	for(; i+4<=n; i+=4) {
+		float64x2_t acc0=vdupq_n_f64(0);
+		float64x2_t acc1=vdupq_n_f64(0);
+		for(size_t k=0; k<taps; k++) {
+			float64x2_t ck=vdupq_n_f64(c[k]);
+			acc0=vaddq_f64(acc0,vmulq_f64(vld1q_f64(x+i-k),ck));
+			acc1=vaddq_f64(acc1,vmulq_f64(vld1q_f64(x+i+2-k),ck));
+		}
+		vst1q_f64(out+i,acc0);
+		vst1q_f64(out+i+2,acc1);
+	}
+	firBlockScalar(x+i,c,taps,out+i,n-i);
+}
+
+static void firBlockIQNeon(const double* x, const double* c, size_t taps,
+			   double* out, size_t n)
+{
+	size_t i=0;
+	for(; i+2<=n; i+=2) {
+		const double* xi=x+2*i;
+		float64x2_t acc0=vdupq_n_f64(0);
+		float64x2_t acc1=vdupq_n_f64(0);
+		for(size_t k=0; k<taps; k++) {
+			float64x2_t ck=vdupq_n_f64(c[k]);
+			acc0=vaddq_f64(acc0,vmulq_f64(vld1q_f64(xi-2*k),ck));
+			acc1=vaddq_f64(acc1,vmulq_f64(vld1q_f64(xi+2-2*k),ck));
+		}
+		vst1q_f64(out+2*i,acc0);
+		vst1q_f64(out+2*i+2,acc1);
+	}
+	firBlockIQScalar(x+2*i,c,taps,out+2*i,n-i);
+}
+
+static void firDecimateIQNeon(const double* x, const double* c, size_t taps,
+			      double* out, size_t n, size_t factor)
+{
+	for(size_t j=0; j<n; j++) {
+		const double* xj=x+2*j*factor;
+		float64x2_t acc=vdupq_n_f64(0);
+		for(size_t k=0; k<taps; k++) {
+			acc=vaddq_f64(acc,vmulq_f64(vld1q_f64(xj-2*k),
+						    vdupq_n_f64(c[k])));
+		}
+		vst1q_f64(out+2*j,acc);
+	}
+}
+#endif
+
+struct FirKernel {
+	const char* name;
+	FirBlockFunc filter;
+	FirBlockFunc filterIQ;
+	FirDecimateFunc decimateIQ;
+};
+
+static const FirKernel kernels[]={
+#ifdef FIR_X86
+	{ "avx2", firBlockAvx2, firBlockIQAvx2, firDecimateIQSse2 },
+	{ "sse2", firBlockSse2, firBlockIQSse2, firDecimateIQSse2 },
+#endif
+#ifdef FIR_NEON
+	{ "neon", firBlockNeon, firBlockIQNeon, firDecimateIQNeon },
+#endif
+	{ "scalar", firBlockScalar, firBlockIQScalar,
+	  firDecimateIQScalar },
+	{ 0, 0, 0, 0 }
+};
+
+static bool kernelSupported(const FirKernel& k)
+{
+#ifdef FIR_X86
+	// may run from a static constructor, before libgcc did it
+	__builtin_cpu_init();
+	if(std::strcmp(k.name,"avx2")==0) {
+		return __builtin_cpu_supports("avx2");
+	}
+	if(std::strcmp(k.name,"sse2")==0) {
+		return __builtin_cpu_supports("sse2");
+	}
+#endif
+	return true;
+}
+
+// The first supported entry of the table is the fastest kernel. The
+// environment variable HAMFAX_FIR can override the choice, e.g. for
+// timing the kernels against each other.
+
+static const FirKernel* selectKernel(const char* name)
+{
+	for(const FirKernel* k=kernels; k->name; k++) {
+		if((name==0 || std::strcmp(name,"auto")==0
+		    || std::strcmp(name,k->name)==0) && kernelSupported(*k)) {
+			return k;
+		}
+	}
+	return 0;
+}
+
+static const FirKernel* defaultKernel(void)
+{
+	const FirKernel* k=selectKernel(std::getenv("HAMFAX_FIR"));
+	return k ? k : selectKernel(0);
+}
+
+// firSetKernel may be called while other threads are filtering
+static QAtomicPointer<const FirKernel> current(defaultKernel());
+
+void firBlock(const double* x, const double* c, size_t taps,
+	      double* out, size_t n)
+{
+	current.loadAcquire()->filter(x,c,taps,out,n);
+}
+
+void firBlockIQ(const double* x, const double* c, size_t taps,
+		double* out, size_t n)
+{
+	current.loadAcquire()->filterIQ(x,c,taps,out,n);
+}
+
+void firDecimateIQ(const double* x, const double* c, size_t taps,
+		   double* out, size_t n, size_t factor)
+{
+	current.loadAcquire()->decimateIQ(x,c,taps,out,n,factor);
+}
+
+bool firSetKernel(const char* name)
+{
+	const FirKernel* k=selectKernel(name);
+	if(k==0) {
+		return false;
+	}
+	current.storeRelease(k);
+	return true;
+}
+
+const char* firKernelName(void)
+{
+	return current.loadAcquire()->name;
+}
@@ -0,0 +1,101 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef FIRKERNELS_HPP
+#define FIRKERNELS_HPP
+
+#include <cstddef>
+
+/**
+ * \file
+ *
+ * Inner loops of the FIR filters. The convolution of a block of samples
+ * is implemented once in plain C++ and once for every supported
+ * instruction set (SSE2, AVX2 and NEON). The best kernel for the running
+ * CPU is selected at startup.
+ *
+ * The vector kernels compute several output samples at once, but every
+ * single output is summed in the same order as by the scalar kernel and
+ * the former FirFilter::filterSample (newest sample times first
+ * coefficient first, no fused multiply-add). All kernels therefore return
+ * bit-identical results, unless the compiler contracts the scalar loop into
+ * fused multiply-adds on its own.
+ */
+
+/**
+ * Filter a block of samples.
+ *
+ * \param x points to the first sample of the block in a linear delay line;
+ * x[-1] down to x[1-taps] have to hold the preceding samples
+ * \param c points to the coefficients
+ * \param taps is the number of coefficients
+ * \param out receives the n output samples, out[i] is the sum of
+ * c[k]*x[i-k] over all k
+ * \param n is the number of samples in the block
+ */
+void firBlock(const double* x, const double* c, size_t taps,
+	      double* out, size_t n);
+
+/**
+ * Filter a block of complex samples with real coefficients. This is the
+ * same as two calls of firBlock for the in-phase and quadrature parts, but
+ * the samples are interleaved (I, Q, I, Q, ...) and both parts share the
+ * coefficient loads.
+ *
+ * \param x points to the first complex sample of the block in a linear
+ * delay line; x[-2] down to x[2-2*taps] have to hold the preceding samples
+ * \param c points to the coefficients
+ * \param taps is the number of coefficients
+ * \param out receives the n interleaved complex output samples
+ * \param n is the number of complex samples in the block
+ */
+void firBlockIQ(const double* x, const double* c, size_t taps,
+		double* out, size_t n);
+
+/**
+ * Filter and decimate a block of complex samples with real coefficients.
+ * Only every factor-th output of firBlockIQ is computed, which is what a
+ * polyphase decimator does: each output uses every coefficient once.
+ *
+ * \param x points to the complex sample of the first output in a linear
+ * delay line, with the same history requirements as for firBlockIQ
+ * \param c points to the coefficients
+ * \param taps is the number of coefficients
+ * \param out receives the n interleaved complex output samples
+ * \param n is the number of complex output samples
+ * \param factor is the decimation factor
+ */
+void firDecimateIQ(const double* x, const double* c, size_t taps,
+		   double* out, size_t n, size_t factor);
+
+/**
+ * Select the kernels used by firBlock, firBlockIQ and firDecimateIQ.
+ *
+ * \param name is one of "scalar", "sse2", "avx2", "neon" or "auto"
+ * \return false if the kernel is not available on this CPU; the
+ * selection is left unchanged in that case
+ */
+bool firSetKernel(const char* name);
+
+/**
+ * Name of the kernels currently used by firBlock, firBlockIQ and
+ * firDecimateIQ.
+ */
+const char* firKernelName(void);
+
+#endif
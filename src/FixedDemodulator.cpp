@@ -0,0 +1,173 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "FixedDemodulator.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const int yBits=12;
+static const int decimatorBits=14;
+
+FixedDemodulator::FixedDemodulator(void)
+	: fm(true), decimation(1), oscillator(13,32767), iqLpf(17),
+	  decimator(1), greyTable((2<<yBits)+1), amThreshold(1024),
+	  iold(0), qold(0), pold(0)
+{
+	oscillator.setInterpolation(true);
+	for(size_t k=0; k<amThreshold.size(); k++) {
+		amThreshold[k]=static_cast<int64_t>(96000*(k+1))*96000*(k+1);
+	}
+}
+
+void FixedDemodulator::init(int sampleRate, int carrier, int deviation,
+			    bool fm, const std::valarray<double>& lowPass,
+			    const std::valarray<double>& decimator,
+			    int decimation)
+{
+	this->fm=fm;
+	this->decimation=decimation;
+	oscillator.setRate(sampleRate);
+	oscillator.setFrequency(carrier);
+	oscillator.reset();
+
+	std::valarray<int32_t> c(lowPass.size());
+	for(size_t i=0; i<c.size(); i++) {
+		c[i]=static_cast<int32_t>(std::floor(lowPass[i]+0.5));
+	}
+	iqLpf.setCoeffs(c);
+	if(decimation>1) {
+		c.resize(decimator.size());
+		for(size_t i=0; i<c.size(); i++) {
+			c[i]=static_cast<int32_t>
+				(std::floor(decimator[i]*(1<<decimatorBits)+0.5));
+		}
+		this->decimator.setCoeffs(c);
+		this->decimator.setDecimation(decimation);
+	}
+
+	const int one=1<<yBits;
+	const double scale=static_cast<double>(sampleRate)/decimation
+		/deviation/2.0/M_PI;
+	for(int y=-one; y<=one; y++) {
+		double x=std::asin(static_cast<double>(y)/one)*scale;
+		x=std::min(std::max(x,-1.0),1.0);
+		greyTable[y+one]=static_cast<int>((x/2.0+0.5)*255.0);
+	}
+	iold=qold=0;
+	pold=0;
+}
+
+int FixedDemodulator::demodulate(const short* audio, int n, int* demod)
+{
+	if(carrierBuffer.size()<2*static_cast<size_t>(n)) {
+		carrierBuffer.resize(2*n);
+		iqBuffer.resize(2*n);
+	}
+	short* osc=&carrierBuffer[0];
+	int32_t* iq=&iqBuffer[0];
+	oscillator.sinCosBlock(osc,n);
+	for(int i=0; i<n; i++) {
+		iq[2*i]=(audio[i]*osc[2*i])>>15;
+		iq[2*i+1]=(audio[i]*osc[2*i+1])>>15;
+	}
+	if(decimation>1) {
+		n=decimator.decimateBlock(iq,iq,n);
+		for(int i=0; i<2*n; i++) {
+			iq[i]>>=decimatorBits;
+		}
+	}
+	iqLpf.filterBlock(iq,iq,n);
+	if(fm) {
+		discriminate(iq,demod,n);
+	} else {
+		demodulateAM(iq,demod,n);
+	}
+	return n;
+}
+
+// Integer square root, digit by digit.
+
+static inline uint32_t squareRoot(uint64_t v)
+{
+	uint64_t r=0;
+	uint64_t b=1ULL<<62;
+	while(b>v) {
+		b>>=2;
+	}
+	while(b) {
+		if(v>=r+b) {
+			v-=r+b;
+			r=(r>>1)+b;
+		} else {
+			r>>=1;
+		}
+		b>>=2;
+	}
+	return static_cast<uint32_t>(r);
+}
+
+// Even shift that brings p below 2^30.
+
+static inline int powerShift(int64_t p)
+{
+	int shift=p>=(1<<30) ? 34-__builtin_clzll(p) : 0;
+	return shift+(shift&1);
+}
+
+// The cross product is normalized by sqrt(|s_t|^2 |s_{t-1}|^2) like in
+// the floating point discriminators, also while the amplitude changes.
+// Both powers are shifted below 2^30 by an even number of bits, so the
+// square root of their product fits 32 bits and the cross product can be
+// shifted by half of both shifts.
+
+void FixedDemodulator::discriminate(const int32_t* iq, int* demod, int n)
+{
+	const int one=1<<yBits;
+	for(int k=0; k<n; k++) {
+		int32_t i0=iq[2*k];
+		int32_t q0=iq[2*k+1];
+		int64_t p0=static_cast<int64_t>(i0)*i0
+			+static_cast<int64_t>(q0)*q0;
+		int64_t cross=static_cast<int64_t>(qold)*i0
+			-static_cast<int64_t>(iold)*q0;
+		int s0=powerShift(p0);
+		int s1=powerShift(pold);
+		int64_t d=squareRoot(static_cast<uint64_t>(p0>>s0)
+				     *static_cast<uint64_t>(pold>>s1));
+		int64_t y=0;
+		if(d>0) {
+			// |cross| <= sqrt(p0*pold)
+			y=(cross>>((s0+s1)/2))*one/d;
+			y=std::min<int64_t>(std::max<int64_t>(y,-one),one);
+		}
+		demod[k] = p0>100000000 ? greyTable[y+one] : 0;
+		iold=i0;
+		qold=q0;
+		pold=p0;
+	}
+}
+
+void FixedDemodulator::demodulateAM(const int32_t* iq, int* demod, int n)
+{
+	for(int k=0; k<n; k++) {
+		int64_t p=static_cast<int64_t>(iq[2*k])*iq[2*k]
+			+static_cast<int64_t>(iq[2*k+1])*iq[2*k+1];
+		demod[k]=std::upper_bound(amThreshold.begin(),amThreshold.end(),p)
+			-amThreshold.begin();
+	}
+}
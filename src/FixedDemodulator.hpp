@@ -0,0 +1,93 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef FIXEDDEMODULATOR_HPP
+#define FIXEDDEMODULATOR_HPP
+
+#include <stdint.h>
+#include <valarray>
+#include <vector>
+#include "IQFirFilter.hpp"
+#include "Nco.hpp"
+
+/**
+ * Integer version of the demodulator in FaxDemodulator, for CPUs where
+ * floating point is slow. The structure is the same:
+ *
+ * - mixing with a Q15 oscillator, the products are shifted back to the
+ *   range of the audio samples
+ * - the decimating low pass with Q14 coefficients and 32 bit sums
+ * - the ACfax low pass with its original integer coefficients and 32 bit
+ *   sums, so the signal has the same scale as in the floating point path
+ * - for FM the discriminator y = (I_{t-1} Q_t - Q_{t-1} I_t) /
+ *   sqrt(|s_t|^2 |s_{t-1}|^2), the same as in the floating point path.
+ *   Both powers are shifted below 30 bit, an integer square root of their
+ *   product and one 64 bit division give y in Q12, and a table maps y to
+ *   the grey value.
+ * - for AM a binary search in the table of the squared thresholds of
+ *   every grey value, which avoids the square root.
+ */
+
+class FixedDemodulator {
+public:
+	FixedDemodulator(void);
+
+	/**
+	 * Get ready for a new reception.
+	 *
+	 * \param sampleRate is the rate of the audio samples
+	 * \param carrier is the carrier frequency in Hz
+	 * \param deviation is the FM deviation in Hz
+	 * \param fm selects FM or AM
+	 * \param lowPass are the (integer valued) ACfax filter coefficients
+	 * \param decimator are the coefficients of the decimating low pass,
+	 * normalized to a sum of one
+	 * \param decimation is the decimation factor
+	 */
+	void init(int sampleRate, int carrier, int deviation, bool fm,
+		  const std::valarray<double>& lowPass,
+		  const std::valarray<double>& decimator, int decimation);
+
+	/**
+	 * Demodulate a block of audio samples.
+	 *
+	 * \param audio points to n audio samples
+	 * \param n is the number of audio samples
+	 * \param demod receives the demodulated values, at most n
+	 * \return the number of demodulated values
+	 */
+	int demodulate(const short* audio, int n, int* demod);
+private:
+	typedef IQFirFilter<int32_t> LPF;
+	void discriminate(const int32_t* iq, int* demod, int n);
+	void demodulateAM(const int32_t* iq, int* demod, int n);
+	bool fm;
+	int decimation;
+	Nco<short> oscillator;
+	LPF iqLpf;
+	LPF decimator;
+	std::valarray<short> carrierBuffer;
+	std::valarray<int32_t> iqBuffer;
+	std::vector<int> greyTable;
+	std::vector<int64_t> amThreshold;
+	int32_t iold;
+	int32_t qold;
+	int64_t pold;
+};
+
+#endif
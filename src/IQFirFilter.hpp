@@ -0,0 +1,217 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef IQFIRFILTER_HPP
+#define IQFIRFILTER_HPP
+
+#include <algorithm>
+#include <valarray>
+#include "FirKernels.hpp"
+
+/**
+ * FIR filter for complex samples with real coefficients, e.g. the low pass
+ * after mixing down to I and Q. The samples are stored interleaved
+ * (I, Q, I, Q, ...), so both parts are filtered in one pass over the
+ * coefficients and every coefficient is loaded only once. The delay line
+ * is linear like in FirFilter.
+ *
+ * With a decimation factor larger than one, decimateBlock computes only
+ * every factor-th output sample. That is the work of a polyphase
+ * decimator: every coefficient is used once per output sample and no
+ * output is computed just to be thrown away.
+ */
+
+template <class T> class IQFirFilter {
+public:
+	/**
+	 * Create the IQFirFilter.
+	 * \param n is the number of coefficients
+	 */
+	IQFirFilter(const size_t n);
+
+	/**
+	 * Set new coefficients.
+	 * \param c are the new coefficients; if the size differs from the
+	 * current size of the filter, the delay line is cleared
+	 */
+	void setCoeffs(const std::valarray<T>& c);
+
+	/**
+	 * Return the number of coefficients.
+	 */
+	size_t size() const;
+
+	/**
+	 * Pass a block of complex samples through the filter.
+	 * \param in points to n interleaved complex samples (2*n values)
+	 * \param out receives the n filtered complex samples; it may be the
+	 * same array as in
+	 * \param n is the number of complex samples
+	 */
+	void filterBlock(const T* in, T* out, size_t n);
+
+	/**
+	 * Set the decimation factor for decimateBlock and restart the
+	 * decimation with the next input sample.
+	 */
+	void setDecimation(size_t factor);
+
+	/**
+	 * Pass a block of complex samples through the filter and keep only
+	 * every factor-th output sample.
+	 * \param in points to n interleaved complex samples (2*n values)
+	 * \param out receives the filtered and decimated complex samples;
+	 * it may be the same array as in
+	 * \param n is the number of complex input samples
+	 * \return the number of complex output samples
+	 */
+	size_t decimateBlock(const T* in, T* out, size_t n);
+private:
+	static const size_t blockSize=512;
+	static void convolve(const T* x, const T* c, size_t taps,
+			     T* out, size_t n);
+	static void decimate(const T* x, const T* c, size_t taps,
+			     T* out, size_t n, size_t factor);
+	std::valarray<T> coeffs;
+	std::valarray<T> buffer;
+	size_t decimation;
+	size_t phase;
+};
+
+template <class T> const size_t IQFirFilter<T>::blockSize;
+
+template <class T> IQFirFilter<T>::IQFirFilter(size_t n)
+	: coeffs(n), buffer(2*(n-1+blockSize)), decimation(1), phase(0)
+{
+}
+
+template <class T> void IQFirFilter<T>::setCoeffs(const std::valarray<T>& c)
+{
+	if(c.size()!=coeffs.size()) {
+		coeffs.resize(c.size());
+		buffer.resize(2*(c.size()-1+blockSize));
+	}
+	coeffs=c;
+}
+
+template <class T> inline size_t IQFirFilter<T>::size() const
+{
+	return coeffs.size();
+}
+
+template <class T> void IQFirFilter<T>::setDecimation(size_t factor)
+{
+	decimation=factor;
+	phase=0;
+}
+
+template <class T> inline void IQFirFilter<T>::convolve(const T* x,
+							 const T* c,
+							 size_t taps,
+							 T* out, size_t n)
+{
+	for(size_t i=0; i<2*n; i+=2) {
+		T isum=0;
+		T qsum=0;
+		for(size_t k=0; k<taps; k++) {
+			isum+=*(x+i-2*k)*c[k];
+			qsum+=*(x+i+1-2*k)*c[k];
+		}
+		out[i]=isum;
+		out[i+1]=qsum;
+	}
+}
+
+template <> inline void IQFirFilter<double>::convolve(const double* x,
+						      const double* c,
+						      size_t taps,
+						      double* out, size_t n)
+{
+	firBlockIQ(x,c,taps,out,n);
+}
+
+template <class T> inline void IQFirFilter<T>::decimate(const T* x,
+							 const T* c,
+							 size_t taps,
+							 T* out, size_t n,
+							 size_t factor)
+{
+	for(size_t j=0; j<n; j++) {
+		const T* xj=x+2*j*factor;
+		T isum=0;
+		T qsum=0;
+		for(size_t k=0; k<taps; k++) {
+			isum+=*(xj-2*k)*c[k];
+			qsum+=*(xj+1-2*k)*c[k];
+		}
+		out[2*j]=isum;
+		out[2*j+1]=qsum;
+	}
+}
+
+template <> inline void IQFirFilter<double>::decimate(const double* x,
+						      const double* c,
+						      size_t taps,
+						      double* out, size_t n,
+						      size_t factor)
+{
+	firDecimateIQ(x,c,taps,out,n,factor);
+}
+
+template <class T>
+inline void IQFirFilter<T>::filterBlock(const T* in, T* out, size_t n)
+{
+	const size_t history=2*(size()-1);
+	T* const x=&buffer[history];
+	while(n>0) {
+		size_t m=std::min(n,blockSize);
+		std::copy(in,in+2*m,x);
+		convolve(x,&coeffs[0],size(),out,m);
+		// keep the newest samples in front of the next block
+		std::copy(x+2*m-history,x+2*m,&buffer[0]);
+		in+=2*m;
+		out+=2*m;
+		n-=m;
+	}
+}
+
+// phase is the position of the next output sample relative to the start
+// of the current block.
+
+template <class T>
+inline size_t IQFirFilter<T>::decimateBlock(const T* in, T* out, size_t n)
+{
+	const size_t history=2*(size()-1);
+	T* const x=&buffer[history];
+	size_t produced=0;
+	while(n>0) {
+		size_t m=std::min(n,blockSize);
+		std::copy(in,in+2*m,x);
+		size_t count = phase<m ? (m-1-phase)/decimation+1 : 0;
+		decimate(x+2*phase,&coeffs[0],size(),out,count,decimation);
+		phase=phase+count*decimation-m;
+		std::copy(x+2*m-history,x+2*m,&buffer[0]);
+		in+=2*m;
+		out+=2*count;
+		produced+=count;
+		n-=m;
+	}
+	return produced;
+}
+
+#endif
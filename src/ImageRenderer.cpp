@@ -0,0 +1,74 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "ImageRenderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+ImageRenderer::ImageRenderer(void)
+	: samples(0), samplesPerLine(1), width(0), color(false)
+{
+}
+
+ImageRenderer::ImageRenderer(const SampleStore* samples, int sampleRate,
+			     double lpm, int width, bool color, int kernel)
+	: samples(samples), samplesPerLine(60.0*sampleRate/lpm),
+	  width(width), color(color)
+{
+	resampler.setup(samplesPerLine,width,kernel);
+}
+
+int ImageRenderer::rows(void) const
+{
+	if(!samples || samples->isEmpty()) {
+		return 0;
+	}
+	return static_cast<int>((samples->size()-1)/samplesPerLine)+1;
+}
+
+int ImageRenderer::imageRows(void) const
+{
+	return color ? (rows()+2)/3 : rows();
+}
+
+// The last row may be incomplete, it only gets the pixels its samples
+// reach.
+
+void ImageRenderer::render(int first, int n, ScanLines& lines) const
+{
+	std::vector<int> in(resampler.length());
+	ScanLine line;
+	for(int r=first; r<first+n; r++) {
+		size_t begin=static_cast<size_t>(std::ceil(r*samplesPerLine));
+		int length=static_cast<int>(std::min(in.size(),
+						     samples->size()-begin));
+		for(int i=0; i<length; i++) {
+			in[i]=samples->at(begin+i);
+		}
+		line.row=color ? r/3 : r;
+		line.channel=color ? r%3 : 3;
+		line.first=0;
+		line.pixels.resize(width);
+		line.pixels.resize(resampler.resample(&in[0],length,0,
+			reinterpret_cast<unsigned char*>(line.pixels.data())));
+		if(!line.pixels.isEmpty()) {
+			lines.append(line);
+		}
+	}
+}
@@ -0,0 +1,77 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef IMAGERENDERER_HPP
+#define IMAGERENDERER_HPP
+
+#include "LineResampler.hpp"
+#include "SampleStore.hpp"
+#include "ScanLine.hpp"
+
+/**
+ * Draws a received image again from its stored samples, e.g. with a
+ * corrected LPM or width.
+ *
+ * Row r is made of the samples from r*samplesPerLine to
+ * (r+1)*samplesPerLine, so every row can be computed on its own, in any
+ * order and by several threads at the same time. The pixels are computed
+ * by a LineResampler. In color mode the rows are the red, green and blue
+ * lines of the image rows one after the other.
+ */
+
+class ImageRenderer {
+public:
+	ImageRenderer(void);
+
+	/**
+	 * \param samples holds the samples, it must not change while rows
+	 * are drawn
+	 * \param sampleRate is the rate of the samples
+	 * \param lpm is the LPM to draw with
+	 * \param width is the number of pixels per line
+	 * \param color selects color mode
+	 * \param kernel is a LineResampler::Kernel
+	 */
+	ImageRenderer(const SampleStore* samples, int sampleRate, double lpm,
+		      int width, bool color, int kernel);
+
+	/**
+	 * Number of rows, counting red, green and blue rows in color mode.
+	 */
+	int rows(void) const;
+
+	/**
+	 * Number of rows of the image.
+	 */
+	int imageRows(void) const;
+
+	/**
+	 * Draw the rows first to first+n-1.
+	 *
+	 * \param lines gets one ScanLine per row
+	 */
+	void render(int first, int n, ScanLines& lines) const;
+private:
+	const SampleStore* samples;
+	double samplesPerLine;
+	int width;
+	bool color;
+	LineResampler resampler;
+};
+
+#endif
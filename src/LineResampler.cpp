@@ -0,0 +1,122 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "LineResampler.hpp"
+#include <algorithm>
+#include <cmath>
+
+LineResampler::LineResampler(void)
+	: lineLength(0), offset(1,0)
+{
+}
+
+static double sinc(double x)
+{
+	return x==0 ? 1.0 : std::sin(M_PI*x)/(M_PI*x);
+}
+
+// Weight of the sample from s to s+1 for a pixel from a to b. Pixels
+// smaller than a sample are treated as one sample wide.
+
+static double weight(int kernel, double s, double a, double b)
+{
+	double size=std::max(b-a,1.0);
+	double x=(s+0.5-(a+b)/2)/size;
+	switch(kernel) {
+	case LineResampler::LINEAR:
+		return std::max(0.0,1.0-std::fabs(x));
+	case LineResampler::SINC:
+		return std::fabs(x)<2 ? sinc(x)*sinc(x/2) : 0.0;
+	default:
+		return std::max(0.0,std::min(x+0.5/size,0.5)
+				-std::max(x-0.5/size,-0.5))*size;
+	}
+}
+
+// The weights are taken from the samples around a pixel that lie inside
+// the line and scaled to a sum of 1<<16, so a pixel at the border gets the
+// weights of the part of the kernel inside the line.
+
+void LineResampler::setup(double samplesPerLine, int width, int kernel)
+{
+	lineLength=static_cast<int>(std::ceil(samplesPerLine));
+	start.resize(width);
+	offset.resize(width+1);
+	weights.resize(0);
+	double size=samplesPerLine/width;
+	double reach=kernel==BOX ? 1 : kernel==LINEAR ? 1.5 : 2.5;
+	std::vector<double> w;
+	for(int c=0; c<width; c++) {
+		double a=c*size;
+		double b=a+size;
+		double r=reach*std::max(size,1.0);
+		int first=std::max(0,static_cast<int>(std::floor((a+b)/2-r)));
+		int last=std::min(lineLength,static_cast<int>
+				  (std::ceil((a+b)/2+r)));
+		while(first<last-1 && weight(kernel,first,a,b)==0) {
+			first++;
+		}
+		while(last>first+1 && weight(kernel,last-1,a,b)==0) {
+			last--;
+		}
+		w.resize(0);
+		double sum=0;
+		for(int s=first; s<last; s++) {
+			w.push_back(weight(kernel,s,a,b));
+			sum+=w.back();
+		}
+		start[c]=first;
+		offset[c]=weights.size();
+		if(sum<=0) {
+			w.assign(w.size(),1.0);
+			sum=w.size();
+		}
+		for(size_t i=0; i<w.size(); i++) {
+			weights.push_back(static_cast<int>
+					  (std::floor(w[i]/sum*65536+0.5)));
+		}
+	}
+	offset[width]=weights.size();
+}
+
+int LineResampler::length(void) const
+{
+	return lineLength;
+}
+
+int LineResampler::resample(const int* in, int n, int first,
+			    unsigned char* out) const
+{
+	int width=start.size();
+	int c;
+	for(c=first; c<width; c++) {
+		const int* x=in+start[c];
+		const int* w=&weights[0]+offset[c];
+		int taps=offset[c+1]-offset[c];
+		if(start[c]+taps>n) {
+			break;
+		}
+		int sum=1<<15;
+		for(int i=0; i<taps; i++) {
+			sum+=w[i]*x[i];
+		}
+		out[c]=static_cast<unsigned char>
+			(std::max(0,std::min(255,sum>>16)));
+	}
+	return c;
+}
@@ -0,0 +1,76 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef LINERESAMPLER_HPP
+#define LINERESAMPLER_HPP
+
+#include <vector>
+
+/**
+ * Turns the samples of one line into pixels.
+ *
+ * The samples that make up a pixel and their weights only depend on the
+ * number of samples per line and the width, so they are computed once in
+ * setup() and kept in tables with 16 bit fixed point weights. Every pixel
+ * gets the same share of the line whatever the phase of the samples is.
+ *
+ * The box kernel averages the samples under a pixel, weighting the
+ * samples at the edges by how much of them falls into it. The linear
+ * kernel is a triangle twice as wide, the sinc kernel a Lanczos window
+ * with two lobes on each side, which keeps edges sharper.
+ */
+
+class LineResampler {
+public:
+	enum Kernel { BOX, LINEAR, SINC };
+
+	LineResampler(void);
+
+	/**
+	 * Compute the tables.
+	 *
+	 * \param samplesPerLine is the number of samples of a line
+	 * \param width is the number of pixels of a line
+	 * \param kernel is one of Kernel
+	 */
+	void setup(double samplesPerLine, int width, int kernel);
+
+	/**
+	 * Number of samples of a line, the samples needed by the last pixel.
+	 */
+	int length(void) const;
+
+	/**
+	 * Compute the pixels from first on as far as the samples of the line
+	 * given so far reach.
+	 *
+	 * \param in holds the samples of the line from its start
+	 * \param n is the number of samples in in
+	 * \param first is the first pixel to compute
+	 * \param out gets the pixels, out[c] for pixel c
+	 * \return the pixel after the last one computed
+	 */
+	int resample(const int* in, int n, int first, unsigned char* out) const;
+private:
+	int lineLength;
+	std::vector<int> start;   // first sample of each pixel
+	std::vector<int> offset;  // first weight of each pixel, one more
+	std::vector<int> weights;
+};
+
+#endif
@@ -0,0 +1,193 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef NCO_HPP
+#define NCO_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Numerically controlled oscillator. The phase is a 32 bit fixed point
+ * number that wraps around by itself, one full turn being 2^32. The
+ * upper bits of the phase index a sine table with a power of two size,
+ * the lower bits are the fraction between two table entries and are used
+ * for linear interpolation if enabled.
+ *
+ * With an integer type the table holds integers, e.g. Q15 values for
+ * Nco<short> with an amplitude of 32767, and the interpolation is done in
+ * integer arithmetic as well.
+ *
+ * The frequency resolution is rate/2^32, so the carrier is exact to far
+ * below 1 mHz instead of being truncated to a multiple of rate/tablesize.
+ */
+
+template <class T> class Nco {
+public:
+	/**
+	 * Create the oscillator.
+	 *
+	 * \param bits is the base 2 logarithm of the table size, less than 32
+	 * and at most 17 for Nco<short>
+	 * \param amplitude is the peak value of the generated signal
+	 */
+	Nco(unsigned int bits, double amplitude=1.0);
+
+	/**
+	 * Switch linear interpolation between the table entries on or off.
+	 */
+	void setInterpolation(bool on);
+
+	/**
+	 * Set the sample rate that increment and setFrequency refer to.
+	 */
+	void setRate(double rate);
+
+	/**
+	 * Phase increment per sample for the frequency f (in Hz).
+	 */
+	uint32_t increment(double f) const;
+
+	/**
+	 * Set the phase increment per sample, e.g. from increment().
+	 */
+	void setIncrement(uint32_t i);
+
+	/**
+	 * Set the frequency in Hz.
+	 */
+	void setFrequency(double f);
+
+	/**
+	 * Set the phase back to zero.
+	 */
+	void reset(void);
+
+	/**
+	 * Return the sine at the current phase and advance the phase.
+	 */
+	T nextSine(void);
+
+	/**
+	 * Generate the next n samples of the complex oscillator, interleaved
+	 * as cosine and sine (I, Q, I, Q, ...).
+	 *
+	 * \param out receives 2*n values
+	 * \param n is the number of complex samples
+	 */
+	void sinCosBlock(T* out, size_t n);
+private:
+	T value(uint32_t p) const;
+	T lerp(T a, T b, uint32_t fraction) const;
+	std::vector<T> table;
+	unsigned int shift;
+	double fractionScale;
+	double phaseScale;
+	bool interpolate;
+	uint32_t phase;
+	uint32_t step;
+};
+
+template <class T> Nco<T>::Nco(unsigned int bits, double amplitude)
+	: table((1u<<bits)+1), shift(32-bits), fractionScale(1.0/(1u<<shift)),
+	  phaseScale(0), interpolate(false), phase(0), step(0)
+{
+	// one extra entry so that interpolation needs no wrap around
+	for(size_t i=0; i<table.size(); i++) {
+		table[i]=static_cast<T>
+			(amplitude*std::sin(2.0*M_PI*i/(table.size()-1)));
+	}
+}
+
+template <class T> inline void Nco<T>::setInterpolation(bool on)
+{
+	interpolate=on;
+}
+
+template <class T> inline void Nco<T>::setRate(double rate)
+{
+	phaseScale=4294967296.0/rate;
+}
+
+template <class T> inline uint32_t Nco<T>::increment(double f) const
+{
+	// negative frequencies wrap to the corresponding phase steps
+	return static_cast<uint32_t>(static_cast<int64_t>(f*phaseScale+0.5));
+}
+
+template <class T> inline void Nco<T>::setIncrement(uint32_t i)
+{
+	step=i;
+}
+
+template <class T> inline void Nco<T>::setFrequency(double f)
+{
+	step=increment(f);
+}
+
+template <class T> inline void Nco<T>::reset(void)
+{
+	phase=0;
+}
+
+template <class T> inline T Nco<T>::lerp(T a, T b, uint32_t fraction) const
+{
+	return static_cast<T>(a+(b-a)*(fraction*fractionScale));
+}
+
+// Q15 fraction, the difference of two neighbouring entries is small enough
+// for the product to fit into 32 bits.
+
+template <> inline short Nco<short>::lerp(short a, short b,
+					  uint32_t fraction) const
+{
+	int32_t f=fraction>>(shift-15);
+	return static_cast<short>(a+(((b-a)*f)>>15));
+}
+
+template <class T> inline T Nco<T>::value(uint32_t p) const
+{
+	uint32_t i=p>>shift;
+	if(!interpolate) {
+		return table[i];
+	}
+	return lerp(table[i],table[i+1],p&((1u<<shift)-1));
+}
+
+template <class T> inline T Nco<T>::nextSine(void)
+{
+	T s=value(phase);
+	phase+=step;
+	return s;
+}
+
+template <class T> inline void Nco<T>::sinCosBlock(T* out, size_t n)
+{
+	const uint32_t quarter=1u<<30;
+	uint32_t p=phase;
+	for(size_t i=0; i<n; i++) {
+		out[2*i]=value(p+quarter);
+		out[2*i+1]=value(p);
+		p+=step;
+	}
+	phase=p;
+}
+
+#endif
@@ -47,6 +47,9 @@ OptionsDialog::OptionsDialog(QWidget* parent)
 	devDSP = addItem(tr("dsp device"), "sound/device");
 	devPTT = addItem(tr("ptt device"), "PTT/device");
 	devPTC = addItem(tr("ptc device"), "PTC/device");
+	decimation = addItem(tr("demodulator decimation (0 = automatic)"),
+			     "modulation/decimation");
+	aptDwell = addItem(tr("apt dwell time (ms)"), "APT/dwell");
 
 	settings->addWidget(new QLabel(tr("ptc speed"), this),row , 1);
 	settings->addWidget(speedPTC = new QComboBox(this), row++, 2);
@@ -61,6 +64,37 @@ OptionsDialog::OptionsDialog(QWidget* parent)
 	};
 	speedPTC->setCurrentIndex(i);
 
+	settings->addWidget(new QLabel(tr("fm discriminator"), this),row , 1);
+	settings->addWidget(discriminator = new QComboBox(this), row++, 2);
+	discriminator->addItem(tr("lookup table"));
+	discriminator->addItem(tr("fast"));
+	discriminator->setCurrentIndex(
+		c.readNumEntry("/hamfax/modulation/discriminator")==1 ? 1 : 0);
+
+	settings->addWidget(new QLabel(tr("demodulator arithmetic"), this),
+			    row , 1);
+	settings->addWidget(arithmetic = new QComboBox(this), row++, 2);
+	arithmetic->addItem(tr("floating point"));
+	arithmetic->addItem(tr("fixed point"));
+	arithmetic->setCurrentIndex(
+		c.readBoolEntry("/hamfax/modulation/fixedPoint") ? 1 : 0);
+
+	// same order as LineResampler::Kernel
+	settings->addWidget(new QLabel(tr("pixel reconstruction"), this),
+			    row , 1);
+	settings->addWidget(kernel = new QComboBox(this), row++, 2);
+	kernel->addItem(tr("box"));
+	kernel->addItem(tr("linear"));
+	kernel->addItem(tr("windowed sinc"));
+	kernel->setCurrentIndex(c.readNumEntry("/hamfax/receiver/kernel"));
+
+	settings->addWidget(new QLabel(tr("slant tracking"), this), row , 1);
+	settings->addWidget(slantTracking = new QComboBox(this), row++, 2);
+	slantTracking->addItem(tr("off"));
+	slantTracking->addItem(tr("on"));
+	slantTracking->setCurrentIndex(
+		c.readBoolEntry("/hamfax/receiver/slantTracking") ? 1 : 0);
+
 #ifdef HAVE_LIBHAMLIB
 	hamlibModel = addItem(tr("hamlib model number"), "HAMLIB/hamlib_model");
 	hamlibParams = addItem(tr("hamlib optional parameters"),
@@ -92,6 +126,16 @@ void OptionsDialog::okClicked(void)
 	c.writeEntry("/hamfax/PTC/device",devPTC->text());
 	c.writeEntry("/hamfax/sound/device",devDSP->text());
 	c.writeEntry("/hamfax/PTT/device",devPTT->text());
+	c.writeEntry("/hamfax/modulation/decimation",
+		     decimation->text().toInt());
+	c.writeEntry("/hamfax/APT/dwell",aptDwell->text().toInt());
+	c.writeEntry("/hamfax/modulation/discriminator",
+		     discriminator->currentIndex());
+	c.writeEntry("/hamfax/modulation/fixedPoint",
+		     arithmetic->currentIndex()==1);
+	c.writeEntry("/hamfax/receiver/kernel",kernel->currentIndex());
+	c.writeEntry("/hamfax/receiver/slantTracking",
+		     slantTracking->currentIndex()==1);
 #ifdef HAVE_LIBHAMLIB
 	c.writeEntry("/hamfax/HAMLIB/hamlib_model",hamlibModel->text());
 	c.writeEntry("/hamfax/HAMLIB/hamlib_parameters",hamlibParams->text());
@@ -37,7 +37,13 @@ private:
 	QLineEdit* devDSP;
 	QLineEdit* devPTT;
 	QLineEdit* devPTC;
+	QLineEdit* decimation;
+	QLineEdit* aptDwell;
 	QComboBox* speedPTC;
+	QComboBox* discriminator;
+	QComboBox* arithmetic;
+	QComboBox* kernel;
+	QComboBox* slantTracking;
 #ifdef HAVE_LIBHAMLIB
 	QLineEdit* hamlibModel;
 	QLineEdit* hamlibParams;
@@ -25,7 +25,6 @@
 #ifdef HAVE_LIBHAMLIB
 #include <stdarg.h>
 #include <vector>
-#include <qmessagebox.h>
 #include "log.h"
 #endif
 
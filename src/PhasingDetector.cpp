@@ -0,0 +1,149 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "PhasingDetector.hpp"
+#include <cmath>
+
+PhasingDetector::PhasingDetector(void)
+	: sampleRate(1), invert(false)
+{
+	restart();
+}
+
+void PhasingDetector::init(int sampleRate, bool invert)
+{
+	this->sampleRate=sampleRate;
+	this->invert=invert;
+	n=0;
+	high=false;
+	pulseWeight=pulseMoment=0;
+	pulseLength=0;
+	restart();
+}
+
+void PhasingDetector::restart(void)
+{
+	lastCenter=-1;
+	lines=0;
+	sumLine=sumLine2=sumCenter=sumLineCenter=0;
+	firstCenter=0;
+	lastLine=0;
+	period=0;
+	start=0;
+	misses=0;
+}
+
+PhasingDetector::Result PhasingDetector::process(int x)
+{
+	Result result=NOTHING;
+	double v=invert ? 255-x : x;
+	if(!high && v>160) {
+		high=true;
+		pulseWeight=pulseMoment=0;
+		pulseLength=0;
+	} else if(high && v<96) {
+		high=false;
+		if(pulseWeight>0) {
+			int before=lines;
+			addPulse(pulseMoment/pulseWeight);
+			if(lines>before && lines>=2) {
+				result=LINE;
+			}
+		}
+	}
+	if(high) {
+		// weights from the middle grey up, so the edges count less
+		double w=v>128 ? v-128 : 0;
+		pulseWeight+=w;
+		pulseMoment+=w*n;
+		pulseLength++;
+	}
+
+	// missing pulses where the fit expects them, the image starts
+	// with the fit so far
+	if(lines>=2 && n>start+(misses+1.1)*period) {
+		if(++misses>=3) {
+			restart();
+			result=END;
+		}
+	}
+	n++;
+	return result;
+}
+
+// A pulse of 3% to 8% of its distance to the last one within the range
+// of 60 to 360 LPM (with some tolerance) starts a fit, further pulses have
+// to be a whole number of periods away from the fit within 1%. A fit of
+// only two pulses may be a chance, so a pulse that does not fit it but
+// pairs with the pulse before starts the fit again.
+
+void PhasingDetector::addPulse(double center)
+{
+	double width=pulseLength;
+	if(lines>=2) {
+		double d=center-start;
+		int k=static_cast<int>(std::floor(d/period+0.5));
+		if(k>=1 && std::fabs(d-k*period)<=0.01*period
+		   && width>=0.03*period && width<=0.08*period) {
+			lastCenter=center;
+			lastLine+=k;
+		} else if(lines>2 || !startFit(center,width)) {
+			lastCenter=center;
+			return;
+		}
+	} else if(!startFit(center,width)) {
+		return;
+	}
+	double c=center-firstCenter;
+	lines++;
+	sumLine+=lastLine;
+	sumLine2+=static_cast<double>(lastLine)*lastLine;
+	sumCenter+=c;
+	sumLineCenter+=lastLine*c;
+	double det=lines*sumLine2-sumLine*sumLine;
+	period=(lines*sumLineCenter-sumLine*sumCenter)/det;
+	start=firstCenter+(sumCenter-period*sumLine)/lines+lastLine*period;
+	misses=0;
+}
+
+bool PhasingDetector::startFit(double center, double width)
+{
+	double d=center-lastCenter;
+	bool fits=lastCenter>=0 && d>=0.15*sampleRate
+		&& d<=1.1*sampleRate && width>=0.03*d && width<=0.08*d;
+	lastCenter=center;
+	if(!fits) {
+		return false;
+	}
+	// the pulse before is line 0 at center 0, it only counts
+	firstCenter=center-d;
+	lines=1;
+	sumLine=sumLine2=sumCenter=sumLineCenter=0;
+	lastLine=1;
+	return true;
+}
+
+double PhasingDetector::lpm(void) const
+{
+	return period>0 ? 60.0*sampleRate/period : 0;
+}
+
+double PhasingDetector::sinceStart(void) const
+{
+	return n-start;
+}
@@ -0,0 +1,96 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef PHASINGDETECTOR_HPP
+#define PHASINGDETECTOR_HPP
+
+/**
+ * Finds the phasing lines at the beginning of a facsimile and measures
+ * the LPM and the start of the lines from them.
+ *
+ * A phasing line is black with a white pulse of 5% of the line around
+ * the start of the line (or white with a black pulse). The pulses are
+ * found with a hysteresis around the middle grey, the center of a pulse
+ * is the centroid of its samples, which is more precise than one sample.
+ * The centers of the pulses that fit the line period are fitted to a
+ * straight line by least squares; its slope is the line period and it
+ * gives the line start. A pulse lost in a fade only leaves a gap, the
+ * following ones still fit. The phasing is over when three pulses in a
+ * row are missing where the fit expects them, even if the fit only has
+ * two pulses, so a fade after the first phasing line does not keep the
+ * image from starting. A fit of two pulses is replaced by the next pair
+ * of pulses that does not fit it.
+ */
+
+class PhasingDetector {
+public:
+	enum Result { NOTHING, LINE, END };
+
+	PhasingDetector(void);
+
+	/**
+	 * Start over.
+	 *
+	 * \param sampleRate is the rate of the demodulated signal
+	 * \param invert is true for black pulses on white lines
+	 */
+	void init(int sampleRate, bool invert);
+
+	/**
+	 * Take the next sample.
+	 *
+	 * \return LINE if a phasing line was found, END if the phasing
+	 * lines are over after at least two of them.
+	 */
+	Result process(int x);
+
+	/**
+	 * The LPM measured so far.
+	 */
+	double lpm(void) const;
+
+	/**
+	 * Samples since the start of the last line found, with a fraction.
+	 */
+	double sinceStart(void) const;
+private:
+	void restart(void);
+	void addPulse(double center);
+	bool startFit(double center, double width);
+	int sampleRate;
+	bool invert;
+	double n;              // number of the current sample
+	bool high;
+	double pulseWeight;    // sums of the current pulse
+	double pulseMoment;
+	int pulseLength;
+	double lastCenter;     // center of the last pulse, -1 for none
+	// least squares fit of center=first+line*period
+	int lines;
+	double sumLine;
+	double sumLine2;
+	double sumCenter;
+	double sumLineCenter;
+	double firstCenter;
+	int lastLine;
+	double period;
+	double start;          // start of the last line found
+	int misses;
+};
+
+#endif
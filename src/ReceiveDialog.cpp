@@ -38,9 +38,14 @@ ReceiveDialog::ReceiveDialog(QWidget* parent)
 	connect(cancel,SIGNAL(clicked()),this,SIGNAL(cancelClicked()));
 }
 
-void ReceiveDialog::apt(int f)
+void ReceiveDialog::apt(int f, double confidence)
 {
-	aptText->setText(QString(tr("Apt frequency: %1 Hz")).arg(f));
+	if(f==0) {
+		aptText->setText(tr("Apt frequency: none"));
+	} else {
+		aptText->setText(QString(tr("Apt frequency: %1 Hz, %2%"))
+				 .arg(f).arg(static_cast<int>(100*confidence)));
+	}
 }
 
 void ReceiveDialog::closeEvent(QCloseEvent* close)
@@ -96,6 +101,16 @@ void ReceiveDialog::imageData(int* buffer, int n)
 	spectrum->samples(buffer,n);
 }
 
+void ReceiveDialog::samples(const QVector<short>& samples)
+{
+	level->samples(const_cast<short*>(samples.constData()),samples.size());
+}
+
+void ReceiveDialog::imageData(const QVector<int>& values)
+{
+	spectrum->samples(const_cast<int*>(values.constData()),values.size());
+}
+
 void ReceiveDialog::disableSkip(void)
 {
 	skip->setDisabled(true);
@@ -22,6 +22,7 @@
 #include <qdialog.h>
 #include <qlabel.h>
 #include <qpushbutton.h>
+#include <QVector>
 #include "DisplayLevel.hpp"
 #include "Spectrum.hpp"
 
@@ -43,13 +44,15 @@ signals:
         void cancelClicked(void);
 	void skipClicked(void);
 public slots:
-	void apt(int f);
+	void apt(int f, double confidence);
 	void phasing(void);
 	void phasingLine(double lpm);
 	void imageRow(int row);
 	void disableSkip(void);
 	void imageData(int* buffer, int n);
 	void samples(short* buffer, int n);
+	void imageData(const QVector<int>& values);
+	void samples(const QVector<short>& samples);
 };
 
 #endif
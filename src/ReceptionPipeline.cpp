@@ -0,0 +1,160 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "ReceptionPipeline.hpp"
+#include "File.hpp"
+#include "config.h"
+#ifdef USE_STATS
+#include "StageStats.hpp"
+#endif
+#include <algorithm>
+
+// how often the level and spectrum displays are updated
+static const int displayInterval=100;
+
+ReceptionPipeline::ReceptionPipeline(void)
+	: QObject(0), source(SOUND), ring(0), file(0), showSamples(false)
+{
+	qRegisterMetaType<QVector<short> >("QVector<short>");
+	qRegisterMetaType<QVector<int> >("QVector<int>");
+	demod=new FaxDemodulator(this);
+	rx=new FaxReceiver(this);
+	timer=new QTimer(this);
+	connect(timer,SIGNAL(timeout()),SLOT(poll()));
+	connect(demod,SIGNAL(data(int*,int)),rx,SLOT(decode(int*,int)));
+	connect(demod,SIGNAL(data(int*,int)),SLOT(demodulated(int*,int)));
+	moveToThread(&thread);
+	thread.start();
+}
+
+ReceptionPipeline::~ReceptionPipeline(void)
+{
+	thread.quit();
+	thread.wait();
+}
+
+FaxDemodulator* ReceptionPipeline::demodulator(void)
+{
+	return demod;
+}
+
+FaxReceiver* ReceptionPipeline::receiver(void)
+{
+	return rx;
+}
+
+void ReceptionPipeline::setSource(RingBuffer<short>* ring)
+{
+	source=SOUND;
+	this->ring=ring;
+}
+
+void ReceptionPipeline::setSource(File* file)
+{
+	source=FILE;
+	this->file=file;
+}
+
+void ReceptionPipeline::setSource(void)
+{
+	source=PTC;
+}
+
+void ReceptionPipeline::setParameters(const FaxParameters& p)
+{
+	parameters=p;
+}
+
+void ReceptionPipeline::start(int sampleRate)
+{
+	displayTime.start();
+	if(source==PTC) {
+		rx->init(sampleRate,parameters);
+		return;
+	}
+	rx->init(demod->init(sampleRate,parameters),parameters);
+	// a file is read as fast as possible, the ring buffer is looked at
+	// every 20 ms
+	timer->start(source==FILE ? 0 : 20);
+}
+
+void ReceptionPipeline::stop(void)
+{
+	timer->stop();
+}
+
+void ReceptionPipeline::ptcData(int* buffer, int n)
+{
+	QVector<int> values(n);
+	std::copy(buffer,buffer+n,values.begin());
+	QMetaObject::invokeMethod(this,"decodeValues",Qt::QueuedConnection,
+				  Q_ARG(QVector<int>,values));
+}
+
+void ReceptionPipeline::poll(void)
+{
+	short buffer[blockSize];
+	if(source==FILE) {
+		int n=file->read(buffer,blockSize);
+		if(n==0) {
+			timer->stop();
+		}
+		// an empty block tells the receiver that the file has ended
+		process(buffer,n);
+	} else {
+		// only what is there now, the capture thread keeps on filling
+		size_t n=ring->fill();
+#ifdef USE_STATS
+		StageStats::stage(StageStats::CAPTURE).queue(n);
+#endif
+		while(n>0 && timer->isActive()) {
+			size_t m=ring->read(buffer,std::min<size_t>(n,blockSize));
+			process(buffer,m);
+			n-=m;
+		}
+	}
+}
+
+void ReceptionPipeline::process(short* buffer, int n)
+{
+	demod->newSamples(buffer,n);
+	if(showSamples) {
+		showSamples=false;
+		QVector<short> s(n);
+		std::copy(buffer,buffer+n,s.begin());
+		emit samples(s);
+	}
+}
+
+void ReceptionPipeline::decodeValues(const QVector<int>& values)
+{
+	rx->decode(const_cast<int*>(values.constData()),values.size());
+}
+
+// Runs right after the receiver got the values, for the spectrum display.
+
+void ReceptionPipeline::demodulated(int* buffer, int n)
+{
+	if(n>0 && displayTime.elapsed()>=displayInterval) {
+		displayTime.restart();
+		QVector<int> values(n);
+		std::copy(buffer,buffer+n,values.begin());
+		emit imageData(values);
+		showSamples=true;
+	}
+}
@@ -0,0 +1,127 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef RECEPTIONPIPELINE_HPP
+#define RECEPTIONPIPELINE_HPP
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include "FaxDemodulator.hpp"
+#include "FaxReceiver.hpp"
+#include "RingBuffer.hpp"
+
+class File;
+
+/**
+ * The receive chain (samples -> FaxDemodulator -> FaxReceiver) running in
+ * a thread of its own. The pipeline owns the demodulator and the receiver
+ * and moves them into its thread, all their signals towards the GUI are
+ * therefore queued. The receiver hands the image over in batches of scan
+ * lines, the level and spectrum displays get a copy of the latest block
+ * of samples a few times per second.
+ *
+ * The samples come from the ring buffer of the sound capture thread, are
+ * read from a file or, for the PTC, are already demodulated and passed in
+ * with ptcData(). The source and the parameters have to be set while no
+ * reception runs. Use
+ * start() and stop() with Qt::BlockingQueuedConnection, so that the
+ * pipeline does not touch the source after stop() returned.
+ */
+
+class ReceptionPipeline : public QObject {
+	Q_OBJECT
+public:
+	enum Source { SOUND, FILE, PTC };
+
+	ReceptionPipeline(void);
+	~ReceptionPipeline(void);
+
+	FaxDemodulator* demodulator(void);
+	FaxReceiver* receiver(void);
+
+	/**
+	 * Take the audio samples from the capture ring buffer.
+	 */
+	void setSource(RingBuffer<short>* ring);
+
+	/**
+	 * Read the audio samples from a file opened with File::startInput.
+	 */
+	void setSource(File* file);
+
+	/**
+	 * Get demodulated values from ptcData().
+	 */
+	void setSource(void);
+
+	/**
+	 * Settings for the next reception.
+	 */
+	void setParameters(const FaxParameters& p);
+public slots:
+	/**
+	 * Initialize demodulator and receiver and start reading the source.
+	 *
+	 * \param sampleRate is the rate of the source
+	 */
+	void start(int sampleRate);
+
+	/**
+	 * Stop reading the source.
+	 */
+	void stop(void);
+
+	/**
+	 * Demodulated values from the PTC. The slot has to be connected with
+	 * Qt::DirectConnection: it copies the values and passes them on to
+	 * the pipeline thread.
+	 */
+	void ptcData(int* buffer, int n);
+signals:
+	/**
+	 * Copy of the latest audio samples, for the level display.
+	 */
+	void samples(const QVector<short>& samples);
+
+	/**
+	 * Copy of the latest demodulated values, for the spectrum.
+	 */
+	void imageData(const QVector<int>& values);
+private slots:
+	void poll(void);
+	void decodeValues(const QVector<int>& values);
+	void demodulated(int* buffer, int n);
+private:
+	void process(short* buffer, int n);
+	static const int blockSize=512;
+	QThread thread;
+	FaxDemodulator* demod;
+	FaxReceiver* rx;
+	QTimer* timer;
+	Source source;
+	FaxParameters parameters;
+	RingBuffer<short>* ring;
+	File* file;
+	QElapsedTimer displayTime;
+	bool showSamples;
+};
+
+#endif
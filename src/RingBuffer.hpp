@@ -0,0 +1,163 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef RINGBUFFER_HPP
+#define RINGBUFFER_HPP
+
+#include <QAtomicInteger>
+#include <algorithm>
+#include <vector>
+
+/**
+ * Lock free ring buffer for exactly one writing and one reading thread.
+ *
+ * The write and read positions count samples from the start and are only
+ * reduced modulo the capacity (a power of two) when the buffer is
+ * accessed, so full and empty can be told apart without a spare slot.
+ * Each position is changed by one thread only; the writer publishes new
+ * samples with a release store of the write position and the reader
+ * frees space with a release store of the read position.
+ *
+ * If the reader falls behind, write() drops the samples that do not fit
+ * and counts them as overruns instead of overwriting samples the reader
+ * may be looking at.
+ */
+
+template <class T> class RingBuffer {
+public:
+	/**
+	 * Create the buffer.
+	 *
+	 * \param minCapacity is rounded up to the next power of two
+	 */
+	RingBuffer(size_t minCapacity=1);
+
+	/**
+	 * Resize the buffer and reset all positions and counters. Neither
+	 * thread may access the buffer during the call.
+	 */
+	void reset(size_t minCapacity);
+
+	/**
+	 * Append samples, called by the writing thread only.
+	 *
+	 * \return the number of samples stored, the rest was dropped
+	 */
+	size_t write(const T* data, size_t n);
+
+	/**
+	 * Take samples out of the buffer, called by the reading thread only.
+	 *
+	 * \return the number of samples copied to data, at most n
+	 */
+	size_t read(T* data, size_t n);
+
+	/**
+	 * Number of samples waiting to be read.
+	 */
+	size_t fill(void) const;
+
+	/**
+	 * The largest fill level seen by write() since the last reset.
+	 */
+	size_t maxFill(void) const;
+
+	/**
+	 * Number of samples dropped because the buffer was full.
+	 */
+	size_t overruns(void) const;
+
+	size_t capacity(void) const;
+private:
+	std::vector<T> buffer;
+	size_t mask;
+	QAtomicInteger<unsigned int> writePos;
+	QAtomicInteger<unsigned int> readPos;
+	QAtomicInteger<unsigned int> dropped;
+	QAtomicInteger<unsigned int> highWater;
+};
+
+template <class T> RingBuffer<T>::RingBuffer(size_t minCapacity)
+{
+	reset(minCapacity);
+}
+
+template <class T> void RingBuffer<T>::reset(size_t minCapacity)
+{
+	size_t c=1;
+	while(c<minCapacity) {
+		c*=2;
+	}
+	buffer.assign(c,T());
+	mask=c-1;
+	writePos.storeRelease(0);
+	readPos.storeRelease(0);
+	dropped.storeRelease(0);
+	highWater.storeRelease(0);
+}
+
+template <class T> size_t RingBuffer<T>::write(const T* data, size_t n)
+{
+	const unsigned int w=writePos.loadAcquire();
+	const size_t used=w-readPos.loadAcquire();
+	const size_t m=std::min(n,buffer.size()-used);
+	const size_t first=std::min(m,buffer.size()-(w&mask));
+	std::copy(data,data+first,&buffer[w&mask]);
+	std::copy(data+first,data+m,&buffer[0]);
+	writePos.storeRelease(w+m);
+	if(m<n) {
+		dropped.fetchAndAddRelaxed(n-m);
+	}
+	if(used+m>highWater.loadAcquire()) {
+		highWater.storeRelease(used+m);
+	}
+	return m;
+}
+
+template <class T> size_t RingBuffer<T>::read(T* data, size_t n)
+{
+	const unsigned int r=readPos.loadAcquire();
+	const size_t m=std::min(n,static_cast<size_t>(writePos.loadAcquire()-r));
+	const size_t first=std::min(m,buffer.size()-(r&mask));
+	std::copy(&buffer[r&mask],&buffer[r&mask]+first,data);
+	std::copy(&buffer[0],&buffer[0]+(m-first),data+first);
+	readPos.storeRelease(r+m);
+	return m;
+}
+
+template <class T> inline size_t RingBuffer<T>::fill(void) const
+{
+	return writePos.loadAcquire()-readPos.loadAcquire();
+}
+
+template <class T> inline size_t RingBuffer<T>::maxFill(void) const
+{
+	return highWater.loadAcquire();
+}
+
+template <class T> inline size_t RingBuffer<T>::overruns(void) const
+{
+	return dropped.loadAcquire();
+}
+
+template <class T> inline size_t RingBuffer<T>::capacity(void) const
+{
+	return buffer.size();
+}
+
+#endif
@@ -0,0 +1,122 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "SampleStore.hpp"
+#include <QDir>
+#include <QTemporaryFile>
+
+SampleStore::SampleStore(void)
+	: count(0), limit(0), external(false), spill(0), spillSize(0)
+{
+}
+
+SampleStore::~SampleStore(void)
+{
+	release();
+}
+
+void SampleStore::setMemoryLimit(size_t bytes)
+{
+	limit=bytes;
+}
+
+void SampleStore::grow(size_t i)
+{
+	while(i>=segments.size()<<segmentBits) {
+		segments.push_back(allocate());
+	}
+}
+
+// The segments of the temporary file are mapped one by one, so the file
+// can grow without moving what is mapped already. The segment size is a
+// multiple of the page size. The store is filled while receiving, where
+// an exception would get lost in the event loop, so if the file does not
+// work the segment is taken from memory after all.
+
+unsigned char* SampleStore::allocate(void)
+{
+	if(!pool.empty()) {
+		unsigned char* s=pool.back();
+		pool.pop_back();
+		return s;
+	}
+	if(limit!=0 && allocated.size()*segmentSize>=limit) {
+		if(!spill) {
+			spill=new QTemporaryFile(QDir::tempPath()
+						 +"/hamfax-XXXXXX");
+			spill->open();
+			spillSize=0;
+		}
+		if(spill->isOpen() && spill->resize(spillSize+segmentSize)) {
+			unsigned char* s=spill->map(spillSize,segmentSize);
+			if(s) {
+				spillSize+=segmentSize;
+				return s;
+			}
+		}
+	}
+	allocated.push_back(new unsigned char[segmentSize]);
+	return allocated.back();
+}
+
+void SampleStore::truncate(size_t n)
+{
+	if(external && n==0) {
+		segments.clear();
+		external=false;
+	}
+	if(n>=count) {
+		return;
+	}
+	count=n;
+	if(external) {
+		return;
+	}
+	size_t used=(n+segmentSize-1)>>segmentBits;
+	while(segments.size()>used) {
+		pool.push_back(segments.back());
+		segments.pop_back();
+	}
+}
+
+void SampleStore::attach(const unsigned char* data, size_t n)
+{
+	release();
+	unsigned char* p=const_cast<unsigned char*>(data);
+	for(size_t i=0; i<n; i+=segmentSize) {
+		segments.push_back(p+i);
+	}
+	count=n;
+	external=true;
+}
+
+void SampleStore::release(void)
+{
+	external=false;
+	segments.clear();
+	pool.clear();
+	for(size_t i=0; i<allocated.size(); i++) {
+		delete[] allocated[i];
+	}
+	allocated.clear();
+	// closing the file removes all mappings
+	delete spill;
+	spill=0;
+	spillSize=0;
+	count=0;
+}
@@ -0,0 +1,123 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef SAMPLESTORE_HPP
+#define SAMPLESTORE_HPP
+
+#include <cstddef>
+#include <vector>
+
+class QTemporaryFile;
+
+/**
+ * Storage for the demodulated samples of one image, one byte per sample.
+ *
+ * The samples are kept in segments of a fixed size. The store grows by
+ * adding segments and never moves samples that are already stored.
+ * Segments that are not used any more go to a pool and are used again
+ * by the next reception. Once the memory limit is reached, further
+ * segments are mapped from a temporary file instead of being allocated.
+ */
+
+class SampleStore {
+public:
+	SampleStore(void);
+	~SampleStore(void);
+
+	/**
+	 * Set how many bytes of samples are kept in memory before the
+	 * temporary file is used. 0 means no limit. Segments already
+	 * allocated are not affected.
+	 */
+	void setMemoryLimit(size_t bytes);
+
+	/**
+	 * Store a sample. The store grows if i is beyond its end; samples
+	 * skipped that way are undefined.
+	 */
+	void put(size_t i, unsigned char value);
+
+	/**
+	 * Get the sample i, which has to be less than size().
+	 */
+	unsigned char at(size_t i) const;
+
+	size_t size(void) const;
+	bool isEmpty(void) const;
+
+	/**
+	 * Drop the samples from n on. Their segments go back to the pool.
+	 */
+	void truncate(size_t n);
+
+	/**
+	 * Use samples that are kept elsewhere, e.g. mapped from a file,
+	 * after releasing everything. They can be read and truncated, but
+	 * put() must not be used until truncate(0) or release() detached the
+	 * store from them again.
+	 */
+	void attach(const unsigned char* data, size_t n);
+
+	/**
+	 * Drop all samples and give all memory and the temporary file back.
+	 */
+	void release(void);
+private:
+	SampleStore(const SampleStore&);
+	SampleStore& operator=(const SampleStore&);
+	void grow(size_t i);
+	unsigned char* allocate(void);
+	static const unsigned int segmentBits=16;
+	static const size_t segmentSize=1<<segmentBits;
+	std::vector<unsigned char*> segments;
+	std::vector<unsigned char*> pool;
+	std::vector<unsigned char*> allocated;
+	size_t count;
+	size_t limit;
+	bool external;
+	QTemporaryFile* spill;
+	size_t spillSize;
+};
+
+inline void SampleStore::put(size_t i, unsigned char value)
+{
+	if(i>=segments.size()<<segmentBits) {
+		grow(i);
+	}
+	segments[i>>segmentBits][i&(segmentSize-1)]=value;
+	if(i>=count) {
+		count=i+1;
+	}
+}
+
+inline unsigned char SampleStore::at(size_t i) const
+{
+	return segments[i>>segmentBits][i&(segmentSize-1)];
+}
+
+inline size_t SampleStore::size(void) const
+{
+	return count;
+}
+
+inline bool SampleStore::isEmpty(void) const
+{
+	return count==0;
+}
+
+#endif
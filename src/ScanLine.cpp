@@ -0,0 +1,47 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "ScanLine.hpp"
+
+void writePixels(QImage& image, int row, const uchar* pixels, int width,
+		 int rgbg, int first)
+{
+	QRgb* p=reinterpret_cast<QRgb*>(image.scanLine(row))+first;
+	switch(rgbg) {
+	case 0:
+		for(int i=0; i<width; i++) {
+			p[i]=qRgb(pixels[i],qGreen(p[i]),qBlue(p[i]));
+		}
+		break;
+	case 1:
+		for(int i=0; i<width; i++) {
+			p[i]=qRgb(qRed(p[i]),pixels[i],qBlue(p[i]));
+		}
+		break;
+	case 2:
+		for(int i=0; i<width; i++) {
+			p[i]=qRgb(qRed(p[i]),qGreen(p[i]),pixels[i]);
+		}
+		break;
+	default:
+		for(int i=0; i<width; i++) {
+			p[i]=qRgb(pixels[i],pixels[i],pixels[i]);
+		}
+		break;
+	};
+}
@@ -0,0 +1,62 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef SCANLINE_HPP
+#define SCANLINE_HPP
+
+#include <QByteArray>
+#include <QImage>
+#include <QMetaType>
+#include <QVector>
+
+/**
+ * A run of decoded pixels in one row of the image. The receiver collects
+ * the pixels in runs and hands them over to the image in batches, which
+ * is much cheaper than one signal per pixel, especially across threads.
+ */
+
+struct ScanLine {
+	/// row in the image
+	int row;
+	/// 0, 1 or 2 for red, green or blue, 3 for grey
+	int channel;
+	/// column of the first pixel
+	int first;
+	/// one grey value per pixel
+	QByteArray pixels;
+};
+
+typedef QVector<ScanLine> ScanLines;
+
+Q_DECLARE_METATYPE(ScanLines)
+
+/**
+ * Write a run of grey values into one row of an RGB32 image.
+ *
+ * \param image is the image, row and the columns have to be inside it
+ * \param row is the row of the image
+ * \param pixels holds the grey values
+ * \param width is the number of pixels
+ * \param rgbg is 0, 1 or 2 to set only the red, green or blue part, or 3
+ * for grey
+ * \param first is the column of the first pixel
+ */
+void writePixels(QImage& image, int row, const uchar* pixels, int width,
+		 int rgbg, int first);
+
+#endif
@@ -0,0 +1,123 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "SlantTracker.hpp"
+#include <algorithm>
+#include <cmath>
+
+// largest shift searched between the rows compared, in pixels
+const int SlantTracker::maxShift=8;
+// shifts taken for one drift
+const int SlantTracker::estimates=8;
+
+SlantTracker::SlantTracker(void)
+	: width(0), distance(1), rows(0), result(0)
+{
+}
+
+void SlantTracker::init(int width, int distance)
+{
+	this->width=width;
+	this->distance=distance;
+	history.resize(static_cast<size_t>(width)*distance);
+	reset();
+}
+
+void SlantTracker::reset(void)
+{
+	rows=0;
+	shifts.resize(0);
+}
+
+bool SlantTracker::addRow(const unsigned char* pixels)
+{
+	if(width<=4*maxShift) {
+		return false;
+	}
+	unsigned char* old=&history[(rows%distance)*width];
+	double s;
+	bool found=false;
+	if(rows>=distance && shift(old,pixels,s)) {
+		shifts.push_back(s/distance);
+		if(static_cast<int>(shifts.size())>=estimates) {
+			std::nth_element(shifts.begin(),
+					 shifts.begin()+estimates/2,
+					 shifts.end());
+			result=shifts[estimates/2];
+			shifts.resize(0);
+			found=true;
+		}
+	}
+	std::copy(pixels,pixels+width,old);
+	rows++;
+	return found;
+}
+
+double SlantTracker::drift(void) const
+{
+	return result;
+}
+
+// The correlation of the rows without their means is computed for every
+// shift, normalized to 1 for identical rows. The peak is refined by a
+// parabola through it and its neighbours.
+
+bool SlantTracker::shift(const unsigned char* a, const unsigned char* b,
+			 double& s) const
+{
+	int n=width-2*maxShift;
+	double meanA=0;
+	double meanB=0;
+	for(int i=maxShift; i<width-maxShift; i++) {
+		meanA+=a[i];
+		meanB+=b[i];
+	}
+	meanA/=n;
+	meanB/=n;
+	double energyA=0;
+	double energyB=0;
+	for(int i=maxShift; i<width-maxShift; i++) {
+		energyA+=(a[i]-meanA)*(a[i]-meanA);
+		energyB+=(b[i]-meanB)*(b[i]-meanB);
+	}
+	// a flat row says nothing about the shift
+	if(energyA<n*25.0 || energyB<n*25.0) {
+		return false;
+	}
+	double c[2*maxShift+1];
+	int best=-maxShift;
+	for(int d=-maxShift; d<=maxShift; d++) {
+		double sum=0;
+		for(int i=maxShift; i<width-maxShift; i++) {
+			sum+=(a[i]-meanA)*(b[i+d]-meanB);
+		}
+		c[d+maxShift]=sum/std::sqrt(energyA*energyB);
+		if(c[d+maxShift]>c[best+maxShift]) {
+			best=d;
+		}
+	}
+	if(c[best+maxShift]<0.6 || best==-maxShift || best==maxShift) {
+		return false;
+	}
+	double l=c[best+maxShift-1];
+	double m=c[best+maxShift];
+	double r=c[best+maxShift+1];
+	double den=l-2*m+r;
+	s=best+(den<0 ? 0.5*(l-r)/den : 0);
+	return true;
+}
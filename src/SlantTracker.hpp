@@ -0,0 +1,78 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef SLANTTRACKER_HPP
+#define SLANTTRACKER_HPP
+
+#include <vector>
+
+/**
+ * Measures the slant of an image while it is received.
+ *
+ * If the clocks of sender and receiver differ, every row is shifted a
+ * little against the one before. Each new row is cross correlated with
+ * the row a number of rows before it, which gives the shift between them
+ * to a fraction of a pixel. Only clear peaks count, rows without
+ * structure or with changing content are skipped. The median of several
+ * shifts divided by the distance of the rows is the drift in pixels per
+ * row.
+ */
+
+class SlantTracker {
+public:
+	SlantTracker(void);
+
+	/**
+	 * Start over.
+	 *
+	 * \param width is the number of pixels per row
+	 * \param distance is the number of rows between the rows compared
+	 */
+	void init(int width, int distance);
+
+	/**
+	 * Forget the rows so far, e.g. after the LPM was corrected.
+	 */
+	void reset(void);
+
+	/**
+	 * Take the next complete row.
+	 *
+	 * \return true if there is a new drift()
+	 */
+	bool addRow(const unsigned char* pixels);
+
+	/**
+	 * Shift from one row to the next in pixels, positive if the image
+	 * content moves to the right.
+	 */
+	double drift(void) const;
+private:
+	bool shift(const unsigned char* a, const unsigned char* b,
+		   double& s) const;
+	static const int maxShift;
+	static const int estimates;
+	int width;
+	int distance;
+	std::vector<unsigned char> history; // distance rows, a ring
+	int rows;
+	std::vector<double> shifts;
+	double result;
+};
+
+#endif
@@ -22,15 +22,29 @@
 #include <sys/ioctl.h>
 #include <sys/soundcard.h>
 #include <unistd.h>
+#include <poll.h>
 #include <qtimer.h>
 #include <qthread.h>
 #include <cstring>
 #include "Config.hpp"
 #include "Error.hpp"
 #include "log.h"
+#ifdef USE_STATS
+#include "StageStats.hpp"
+#endif
+
+class CaptureThread : public QThread {
+public:
+	CaptureThread(Sound* sound) : sound(sound) {}
+protected:
+	void run(void) { sound->capture(); }
+private:
+	Sound* sound;
+};
 
 Sound::Sound(QObject* parent)
-	: QObject(parent), sampleRate(8000), 
+	: QObject(parent), captureThread(0),
+	  sampleRate(8000), 
 	  use_alsa(1),
 #ifdef USE_ALSA
 	  pcm(NULL), handler(NULL), frames(512), framesize(sizeof(short)),
@@ -53,6 +67,7 @@ Sound::Sound(QObject* parent)
 
 Sound::~Sound(void)
 {
+	stopCapture();
 	if(dsp!=-1) {
 		::close(dsp);
 	}
@@ -311,7 +326,6 @@ int Sound::startInput(void)
 
 		buffer=(short *)malloc(frames * framesize);
 		
-		setupNotifiers(SLOT(readALSA(int)));
 		snd_pcm_start(pcm);
 		
 	     } else {
@@ -336,15 +350,15 @@ int Sound::startInput(void)
 	        if(speed<(sampleRate*0.99) || speed>(sampleRate*1.01)) {
 	        	throw Error(tr("could not set sample rate"));
 		}
-		notifier=new QSocketNotifier(dsp,QSocketNotifier::Read,this);
-		connect(notifier,SIGNAL(activated(int)),SLOT(read(int)));
-
-		// trigger the file descriptor reads
-		read (dsp);
-
 #ifdef USE_ALSA
 	     }
 #endif /* USE_ALSA */
+		// about two seconds of audio before samples get lost
+		ring.reset(2*sampleRate);
+		overrunCount.storeRelease(0);
+		captureStop.storeRelease(0);
+		captureThread=new CaptureThread(this);
+		captureThread->start(QThread::TimeCriticalPriority);
 	} catch(Error) {
 		close();
 		throw;
@@ -354,25 +368,23 @@ int Sound::startInput(void)
 
 void Sound::end(void)
 {
+	// reception, the capture thread is simply stopped
+	if(captureThread) {
+		close();
+		return;
+	}
 #ifdef USE_ALSA
 	if (pcm) snd_pcm_drain(pcm);
 #endif /* USE_ALSA */
 	
 	if(notifier) {
 		notifier->setEnabled(false);
-		if(notifier->type()==QSocketNotifier::Read) {
-			disconnect(notifier,SIGNAL(activated(int)),
-				   this,SLOT(read(int)));
-			close();
-		} else {
-			disconnect(notifier,SIGNAL(activated(int)),
-				   this,SLOT(checkSpace(int)));
-			int i=2;
-			if (dsp!=-1) ioctl(dsp,SNDCTL_DSP_GETODELAY,&i);
-			QTimer::singleShot(1000*i
-					   /sampleRate/sizeof(short),
-					   this,SLOT(close()));
-		}
+		disconnect(notifier,SIGNAL(activated(int)),
+			   this,SLOT(checkSpace(int)));
+		int i=2;
+		if (dsp!=-1) ioctl(dsp,SNDCTL_DSP_GETODELAY,&i);
+		QTimer::singleShot(1000*i/sampleRate/sizeof(short),
+				   this,SLOT(close()));
 		delete notifier;
 		notifier=NULL;
 	} else {
@@ -418,56 +430,95 @@ void Sound::write(short* samples, int number)
 	}
 }
 
-void Sound::read(int fd)
+RingBuffer<short>& Sound::captureBuffer(void)
 {
-	short buffer[512];
-	int n;
-
-	n = ::read(fd, buffer, sizeof(buffer));
-	if ( n > 0 )
-		emit data(buffer, n / sizeof(short));
+	return ring;
 }
 
-#ifdef USE_ALSA
-void Sound::readALSA(int fd)
+int Sound::deviceOverruns(void) const
 {
-	int n;
-	unsigned short revents;
+	return overrunCount.loadAcquire();
+}
 
-	snd_pcm_poll_descriptors_revents(pcm, pollfds, count_fds, &revents);
-	if (revents & POLLERR) {
-		snd_pcm_recover(pcm, -EPIPE, 0);
-		return;
-	}
+// Runs in the capture thread. The waits time out now and then, so that
+// stopCapture does not have to wait for samples that never come.
 
-	if (!(revents & POLLIN))
-		return;
+void Sound::capture(void)
+{
+	short samples[512];
+	while(!captureStop.loadAcquire()) {
+#ifdef USE_ALSA
+		if(pcm) {
+			if(snd_pcm_wait(pcm,100)==0) {
+				continue;
+			}
+			int n=snd_pcm_readi(pcm, buffer, frames);
+			if (n == -EPIPE) {
+			   // overrun
+			   log_debug("ALSA overrun");
+			   overrunCount.fetchAndAddRelaxed(1);
+#ifdef USE_STATS
+			   StageStats::stage(StageStats::CAPTURE).overrun();
+#endif
+			   snd_pcm_recover(pcm,n,0);
+			   snd_pcm_start(pcm);
+			} else if (n == -EAGAIN) {
+			   // no data available
+			} else if (n < 0) {
+			   // other error - recover or print
+			   if (snd_pcm_recover(pcm,n,0)) {
+			      log_debug("ALSA Read error:%s",snd_strerror(n));
+			      snd_pcm_prepare(pcm);
+			      }
+			   snd_pcm_start(pcm);
+			} else if (n<=(int)frames) {
+				store(buffer,n);
+			}
+			continue;
+		}
+#endif /* USE_ALSA */
+		pollfd p;
+		p.fd=dsp;
+		p.events=POLLIN;
+		if(poll(&p,1,100)<=0) {
+			continue;
+		}
+		int n=::read(dsp, samples, sizeof(samples));
+		if(n>0) {
+			store(samples,n/sizeof(short));
+		}
+	}
+}
 
-	n=snd_pcm_readi(pcm, buffer, frames);
-	if (n == -EPIPE) {
-	   // overrun
-	   log_debug("ALSA overrun");
-	   snd_pcm_recover(pcm,n,0);
-	   snd_pcm_start(pcm);
-	} else if (n == -EAGAIN) {
-	   // no data available
-	} else if (n < 0) {
-	   // other error - recover or print
-	   if (snd_pcm_recover(pcm,n,0)) {
-	      log_debug("ALSA Read error:%s",snd_strerror(n));
-	      snd_pcm_prepare(pcm);
-	      }
-	   snd_pcm_start(pcm);
+void Sound::store(const short* samples, int n)
+{
+#ifdef USE_STATS
+	StageTimer timer(StageStats::CAPTURE,n);
+	if(ring.write(samples,n)<static_cast<size_t>(n)) {
+		StageStats::stage(StageStats::CAPTURE).droppedBlock();
 	}
-	  
-	if(n>0 && n<=(int)frames) {
-		emit data(buffer,n);
+#else
+	ring.write(samples,n);
+#endif
+}
+
+void Sound::stopCapture(void)
+{
+	if(captureThread) {
+		captureStop.storeRelease(1);
+		captureThread->wait();
+		delete captureThread;
+		captureThread=0;
+		if(ring.overruns()>0 || deviceOverruns()>0) {
+			log_debug("capture: %lu samples dropped, %d device "
+				  "overruns, maximum fill %lu of %lu",
+				  (unsigned long)ring.overruns(),
+				  deviceOverruns(),
+				  (unsigned long)ring.maxFill(),
+				  (unsigned long)ring.capacity());
+		}
 	}
 }
-#else /* USE_ALSA */
-// empty stub since it cannot be ifdef'ed in the hpp file
-void Sound::readALSA(int fd) { }
-#endif /* USE_ALSA */
 
 void Sound::checkSpace(int fd)
 {
@@ -494,6 +545,7 @@ void Sound::checkSpace(int fd)
 
 void Sound::close(void)
 {
+	stopCapture();
 	if (dsp!=-1) {
 	   ioctl(dsp,SNDCTL_DSP_RESET);
 	   ::close(dsp);
@@ -528,7 +580,7 @@ void Sound::close(void)
 void Sound::closeNow(void)
 {
 	log_debug("Sound::closeNow");
-	if(dsp!=-1) {
+	if(notifier) {
 		notifier->setEnabled(false);
 		delete notifier;
 		notifier=NULL;
@@ -29,6 +29,7 @@
 #include <qthread.h>
 #include <qsocketnotifier.h>
 #include "PTT.hpp"
+#include "RingBuffer.hpp"
 #include "config.h"
 
 #ifdef USE_ALSA
@@ -36,14 +37,44 @@
 #include <alsa/asoundlib.h>
 #endif
 
+class CaptureThread;
+
+/**
+ * Sound card access. For reception a capture thread reads the sound
+ * device and stores the samples in a ring buffer, so that the timing of
+ * the device reads does not depend on how busy the other threads are.
+ * The ReceptionPipeline takes the samples out of the ring buffer again.
+ */
+
 class Sound : public QObject {
 	Q_OBJECT
+	friend class CaptureThread;
 public:
 	Sound(QObject* parent);
 	~Sound(void);
 	int startOutput(void);
 	int startInput(void);
+
+	/**
+	 * The ring buffer filled by the capture thread. Only one thread may
+	 * read from it; its fill level and overrun counters can be looked at
+	 * from everywhere.
+	 */
+	RingBuffer<short>& captureBuffer(void);
+
+	/**
+	 * Number of overruns reported by the sound device since the start
+	 * of the reception.
+	 */
+	int deviceOverruns(void) const;
 private:
+	void capture(void);
+	void store(const short* samples, int n);
+	void stopCapture(void);
+	RingBuffer<short> ring;
+	CaptureThread* captureThread;
+	QAtomicInt captureStop;
+	QAtomicInt overrunCount;
 	int sampleRate;
 	int use_alsa;
 #ifdef USE_ALSA
@@ -73,7 +104,6 @@ private:
 	PTT ptt;
 	int rateF;
 signals:
-        void data(short*, int);
 	void deviceClosed(void);
 	void spaceLeft(int);
 public slots:
@@ -82,9 +112,6 @@ public slots:
 	void write(short* samples, int number);
 private slots:
 	void checkSpace(int fd);
-        void read(int fd);
-	// readALSA should be ifdef'ed, but this does not work with moc
-        void readALSA(int fd);
 	void close(void);
 };
 
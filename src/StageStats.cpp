@@ -0,0 +1,218 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "StageStats.hpp"
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+static QAtomicInteger<qint64> resetTime;
+
+// the innermost running timer of each thread
+static thread_local StageTimer* current=0;
+
+StageStats::StageStats(void)
+{
+	reset();
+}
+
+StageStats& StageStats::stage(Stage s)
+{
+	static StageStats stages[STAGES];
+	return stages[s];
+}
+
+const char* StageStats::name(Stage s)
+{
+	static const char* names[STAGES]={
+		"capture", "demodulator", "receiver", "image"
+	};
+	return names[s];
+}
+
+static QElapsedTimer startedClock(void)
+{
+	QElapsedTimer clock;
+	clock.start();
+	return clock;
+}
+
+qint64 StageStats::now(void)
+{
+	static const QElapsedTimer clock=startedClock();
+	return clock.nsecsElapsed();
+}
+
+void StageStats::resetAll(void)
+{
+	for(int i=0; i<STAGES; i++) {
+		stage(static_cast<Stage>(i)).reset();
+	}
+	resetTime.storeRelease(now());
+}
+
+void StageStats::reset(void)
+{
+	sampleCount.storeRelease(0);
+	callCount.storeRelease(0);
+	ns.storeRelease(0);
+	fill.storeRelease(0);
+	maxFill.storeRelease(0);
+	overrunCount.storeRelease(0);
+	droppedCount.storeRelease(0);
+	for(int i=0; i<buckets; i++) {
+		histo[i].storeRelease(0);
+	}
+}
+
+QByteArray StageStats::dump(void)
+{
+	QJsonArray list;
+	for(int i=0; i<STAGES; i++) {
+		const StageStats& s=stage(static_cast<Stage>(i));
+		QJsonArray histogram;
+		for(int b=0; b<buckets; b++) {
+			histogram.append(static_cast<double>(s.histogram(b)));
+		}
+		QJsonObject o;
+		o["stage"]=QString(name(static_cast<Stage>(i)));
+		o["samples"]=static_cast<double>(s.samples());
+		o["calls"]=static_cast<double>(s.calls());
+		o["ns"]=static_cast<double>(s.nanoseconds());
+		o["samplesPerSecond"]=s.samplesPerSecond();
+		o["nsPerSample"]=s.nsPerSample();
+		o["load"]=s.load();
+		o["queueDepth"]=static_cast<double>(s.queueDepth());
+		o["maxQueueDepth"]=static_cast<double>(s.maxQueueDepth());
+		o["overruns"]=static_cast<double>(s.overruns());
+		o["droppedBlocks"]=static_cast<double>(s.droppedBlocks());
+		o["histogram"]=histogram;
+		list.append(o);
+	}
+	QJsonObject root;
+	root["seconds"]=(now()-resetTime.loadAcquire())/1e9;
+	root["stages"]=list;
+	return QJsonDocument(root).toJson();
+}
+
+void StageStats::add(int n, qint64 time)
+{
+	sampleCount.fetchAndAddRelaxed(n);
+	callCount.fetchAndAddRelaxed(1);
+	ns.fetchAndAddRelaxed(time);
+	int b=0;
+	while(time>1 && b<buckets-1) {
+		time>>=1;
+		b++;
+	}
+	histo[b].fetchAndAddRelaxed(1);
+}
+
+void StageStats::queue(size_t n)
+{
+	fill.storeRelease(n);
+	if(n>maxFill.loadAcquire()) {
+		maxFill.storeRelease(n);
+	}
+}
+
+void StageStats::overrun(void)
+{
+	overrunCount.fetchAndAddRelaxed(1);
+}
+
+void StageStats::droppedBlock(void)
+{
+	droppedCount.fetchAndAddRelaxed(1);
+}
+
+quint64 StageStats::samples(void) const
+{
+	return sampleCount.loadAcquire();
+}
+
+quint64 StageStats::calls(void) const
+{
+	return callCount.loadAcquire();
+}
+
+quint64 StageStats::nanoseconds(void) const
+{
+	return ns.loadAcquire();
+}
+
+quint64 StageStats::queueDepth(void) const
+{
+	return fill.loadAcquire();
+}
+
+quint64 StageStats::maxQueueDepth(void) const
+{
+	return maxFill.loadAcquire();
+}
+
+quint64 StageStats::overruns(void) const
+{
+	return overrunCount.loadAcquire();
+}
+
+quint64 StageStats::droppedBlocks(void) const
+{
+	return droppedCount.loadAcquire();
+}
+
+quint64 StageStats::histogram(int bucket) const
+{
+	return histo[bucket].loadAcquire();
+}
+
+double StageStats::samplesPerSecond(void) const
+{
+	qint64 wall=now()-resetTime.loadAcquire();
+	return wall>0 ? 1e9*samples()/wall : 0.0;
+}
+
+double StageStats::nsPerSample(void) const
+{
+	quint64 n=samples();
+	return n>0 ? static_cast<double>(nanoseconds())/n : 0.0;
+}
+
+double StageStats::load(void) const
+{
+	qint64 wall=now()-resetTime.loadAcquire();
+	return wall>0 ? static_cast<double>(nanoseconds())/wall : 0.0;
+}
+
+StageTimer::StageTimer(StageStats::Stage stage, int samples)
+	: stats(StageStats::stage(stage)), samples(samples),
+	  start(StageStats::now()), inner(0), outer(current)
+{
+	current=this;
+}
+
+StageTimer::~StageTimer(void)
+{
+	qint64 time=StageStats::now()-start;
+	stats.add(samples,time-inner);
+	if(outer) {
+		outer->inner+=time;
+	}
+	current=outer;
+}
@@ -0,0 +1,143 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef STAGESTATS_HPP
+#define STAGESTATS_HPP
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QString>
+
+/**
+ * Counters for the stages of the receive chain. Every stage counts the
+ * samples it processed, the time it spent on them and a histogram of the
+ * time per call in powers of two nanoseconds. The capture stage also
+ * keeps the fill level of the capture ring buffer, the overruns of the
+ * sound device and the blocks of which samples were dropped.
+ *
+ * The counters are atomic and only added to, so that the stages can
+ * count from their own threads while the status panel reads them. They
+ * are only built with --enable-stats, the code using them has to be
+ * enclosed in #ifdef USE_STATS.
+ */
+
+class StageStats {
+public:
+	enum Stage { CAPTURE, DEMODULATOR, RECEIVER, IMAGE, STAGES };
+	static const int buckets=32;
+
+	/**
+	 * The counters of one stage.
+	 */
+	static StageStats& stage(Stage s);
+
+	/**
+	 * Short name of the stage, as used in the dump.
+	 */
+	static const char* name(Stage s);
+
+	/**
+	 * Nanoseconds on a monotonic clock.
+	 */
+	static qint64 now(void);
+
+	/**
+	 * Set all counters of all stages to zero, the rates are computed
+	 * from this point in time on.
+	 */
+	static void resetAll(void);
+
+	/**
+	 * All counters as a JSON document.
+	 */
+	static QByteArray dump(void);
+
+	/**
+	 * Count one call that processed n samples in ns nanoseconds.
+	 */
+	void add(int n, qint64 ns);
+
+	/**
+	 * Record the number of samples waiting in front of the stage.
+	 */
+	void queue(size_t fill);
+
+	void overrun(void);
+	void droppedBlock(void);
+
+	quint64 samples(void) const;
+	quint64 calls(void) const;
+	quint64 nanoseconds(void) const;
+	quint64 queueDepth(void) const;
+	quint64 maxQueueDepth(void) const;
+	quint64 overruns(void) const;
+	quint64 droppedBlocks(void) const;
+
+	/**
+	 * Number of calls that took from 2^bucket to 2^(bucket+1)
+	 * nanoseconds.
+	 */
+	quint64 histogram(int bucket) const;
+
+	/**
+	 * Samples per second of wall time since the last reset.
+	 */
+	double samplesPerSecond(void) const;
+
+	/**
+	 * Average time spent on one sample.
+	 */
+	double nsPerSample(void) const;
+
+	/**
+	 * Share of the wall time since the last reset spent in the stage.
+	 */
+	double load(void) const;
+private:
+	StageStats(void);
+	void reset(void);
+	QAtomicInteger<quint64> sampleCount;
+	QAtomicInteger<quint64> callCount;
+	QAtomicInteger<quint64> ns;
+	QAtomicInteger<quint64> fill;
+	QAtomicInteger<quint64> maxFill;
+	QAtomicInteger<quint64> overrunCount;
+	QAtomicInteger<quint64> droppedCount;
+	QAtomicInteger<quint64> histo[buckets];
+};
+
+/**
+ * Measures the time until it goes out of scope and adds it to a stage.
+ * Timers may be nested within a thread: the time of an inner timer is
+ * only counted for its own stage, e.g. the receiver that is called by
+ * the demodulator through a direct connection.
+ */
+
+class StageTimer {
+public:
+	StageTimer(StageStats::Stage stage, int samples);
+	~StageTimer(void);
+private:
+	StageStats& stats;
+	int samples;
+	qint64 start;
+	qint64 inner;
+	StageTimer* outer;
+};
+
+#endif
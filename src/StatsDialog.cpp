@@ -0,0 +1,114 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "StatsDialog.hpp"
+#include <QBoxLayout>
+#include <QFile>
+#include <QFileDialog>
+#include <QGridLayout>
+#include <QMessageBox>
+#include <QPushButton>
+
+StatsDialog::StatsDialog(QWidget* parent)
+	: QDialog(parent)
+{
+	setWindowTitle(tr("receive statistics"));
+	QBoxLayout* layout=new QBoxLayout(QBoxLayout::TopToBottom, this);
+	QGridLayout* grid=new QGridLayout;
+	layout->addLayout(grid);
+	const char* titles[COLUMNS]={
+		QT_TR_NOOP("samples/s"), QT_TR_NOOP("ns/sample"),
+		QT_TR_NOOP("load"), QT_TR_NOOP("queue (max)"),
+		QT_TR_NOOP("overruns"), QT_TR_NOOP("dropped blocks")
+	};
+	for(int c=0; c<COLUMNS; c++) {
+		grid->addWidget(new QLabel(tr(titles[c]),this),0,c+1);
+	}
+	for(int s=0; s<StageStats::STAGES; s++) {
+		grid->addWidget(new QLabel(StageStats::name
+					   (static_cast<StageStats::Stage>(s)),
+					   this),s+1,0);
+		for(int c=0; c<COLUMNS; c++) {
+			cells[s][c]=new QLabel(this);
+			cells[s][c]->setAlignment(Qt::AlignRight);
+			grid->addWidget(cells[s][c],s+1,c+1);
+		}
+	}
+
+	QBoxLayout* buttons=new QBoxLayout(QBoxLayout::LeftToRight);
+	layout->addLayout(buttons);
+	QPushButton* button=new QPushButton(tr("&Reset"),this);
+	buttons->addWidget(button);
+	connect(button,SIGNAL(clicked()),SLOT(reset()));
+	button=new QPushButton(tr("&Save"),this);
+	buttons->addWidget(button);
+	connect(button,SIGNAL(clicked()),SLOT(save()));
+	button=new QPushButton(tr("&Close"),this);
+	buttons->addWidget(button);
+	connect(button,SIGNAL(clicked()),SLOT(hide()));
+
+	timer=new QTimer(this);
+	connect(timer,SIGNAL(timeout()),SLOT(refresh()));
+	timer->start(1000);
+	refresh();
+}
+
+void StatsDialog::refresh(void)
+{
+	if(!isVisible()) {
+		return;
+	}
+	for(int s=0; s<StageStats::STAGES; s++) {
+		const StageStats& stats=
+			StageStats::stage(static_cast<StageStats::Stage>(s));
+		cells[s][SAMPLES]->setNum(static_cast<int>
+					  (stats.samplesPerSecond()+0.5));
+		cells[s][TIME]->setText(QString::number(stats.nsPerSample(),
+							'f',1));
+		cells[s][LOAD]->setText(QString("%1%")
+					.arg(100*stats.load(),0,'f',1));
+		cells[s][QUEUE]->setText(QString("%1 (%2)")
+					 .arg(stats.queueDepth())
+					 .arg(stats.maxQueueDepth()));
+		cells[s][OVERRUNS]->setText(QString::number(stats.overruns()));
+		cells[s][DROPPED]->setText(QString::number
+					   (stats.droppedBlocks()));
+	}
+}
+
+void StatsDialog::reset(void)
+{
+	StageStats::resetAll();
+	refresh();
+}
+
+void StatsDialog::save(void)
+{
+	QString fileName=QFileDialog::getSaveFileName(this,
+						      tr("Save statistics"),
+						      "stats.json");
+	if(fileName.isEmpty()) {
+		return;
+	}
+	QFile file(fileName);
+	if(!file.open(QIODevice::WriteOnly)
+	   || file.write(StageStats::dump())<0) {
+		QMessageBox::warning(this,windowTitle(),
+				     tr("could not save %1").arg(fileName));
+	}
+}
@@ -0,0 +1,48 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef STATSDIALOG_HPP
+#define STATSDIALOG_HPP
+
+#include <QDialog>
+#include <QLabel>
+#include <QTimer>
+#include "StageStats.hpp"
+
+/**
+ * Status panel for the counters of the receive chain. The table shows
+ * for every stage the samples per second, the time per sample, the share
+ * of the wall time spent in the stage, the queue depth and the lost
+ * samples and is updated every second while the panel is visible.
+ */
+
+class StatsDialog : public QDialog {
+	Q_OBJECT
+public:
+	StatsDialog(QWidget* parent);
+private:
+	enum { SAMPLES, TIME, LOAD, QUEUE, OVERRUNS, DROPPED, COLUMNS };
+	QLabel* cells[StageStats::STAGES][COLUMNS];
+	QTimer* timer;
+private slots:
+	void refresh(void);
+	void reset(void);
+	void save(void);
+};
+
+#endif
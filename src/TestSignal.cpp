@@ -0,0 +1,153 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "TestSignal.hpp"
+#include "FaxDemodulator.hpp"
+#include "FaxModulator.hpp"
+#include "FaxTransmitter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+TestSignal::TestSignal(QObject* parent)
+	: QObject(parent), demodulated(0), done(false)
+{
+}
+
+// The upper half holds a horizontal gray ramp and bars of growing width,
+// the lower half a checkerboard and a diagonal. In color the channels
+// differ, so that mixed up channels show.
+
+QImage TestSignal::testImage(int width, int height, bool color)
+{
+	QImage image(width,height,QImage::Format_RGB32);
+	for(int r=0; r<height; r++) {
+		for(int c=0; c<width; c++) {
+			int g;
+			if(r<height/4) {
+				g=255*c/std::max(width-1,1);
+			} else if(r<height/2) {
+				int bar=1+8*c/width;
+				g=(c/bar)%2 ? 255 : 0;
+			} else if(std::abs(c*height-2*(r-height/2)*width)
+				  <2*width) {
+				g=0;
+			} else {
+				g=((c/16+r/16)%2) ? 224 : 32;
+			}
+			if(color) {
+				image.setPixel(c,r,qRgb(g,255*r/height,255-g));
+			} else {
+				image.setPixel(c,r,qRgb(g,g,g));
+			}
+		}
+	}
+	return image;
+}
+
+void TestSignal::modulate(const QImage& image, int sampleRate,
+			  const FaxParameters& p)
+{
+	FaxTransmitter transmitter(0);
+	FaxModulator modulator(0);
+	connect(&transmitter,SIGNAL(data(double*,int)),
+		&modulator,SLOT(modulate(double*,int)));
+	connect(&modulator,SIGNAL(data(short*,int)),SLOT(store(short*,int)));
+	connect(&transmitter,SIGNAL(end()),SLOT(finished()));
+	audio.clear();
+	done=false;
+	transmitter.setImage(image.convertToFormat(QImage::Format_RGB32));
+	transmitter.start(sampleRate,p);
+	modulator.init(sampleRate,p);
+	while(!done) {
+		transmitter.doNext(1024);
+	}
+}
+
+void TestSignal::addNoise(double snr, unsigned int seed)
+{
+	double power=0;
+	for(size_t i=0; i<audio.size(); i++) {
+		power+=static_cast<double>(audio[i])*audio[i];
+	}
+	power/=std::max<size_t>(audio.size(),1);
+	std::mt19937 random(seed);
+	std::normal_distribution<double> noise(0.0,std::sqrt(power)
+					       *std::pow(10.0,-snr/20));
+	for(size_t i=0; i<audio.size(); i++) {
+		double x=audio[i]+noise(random);
+		audio[i]=static_cast<short>(std::max(-32768.0,
+						     std::min(32767.0,x)));
+	}
+}
+
+// Linear interpolation is good enough, the carrier is far below the
+// Nyquist frequency.
+
+void TestSignal::addDrift(double ppm)
+{
+	double step=1.0+ppm*1e-6;
+	std::vector<short> in;
+	in.swap(audio);
+	for(double t=0; t+1<in.size(); t+=step) {
+		size_t i=static_cast<size_t>(t);
+		double f=t-i;
+		audio.push_back(static_cast<short>
+				(std::floor((1-f)*in[i]+f*in[i+1]+0.5)));
+	}
+}
+
+int TestSignal::demodulate(int sampleRate, const FaxParameters& p,
+			   std::vector<int>& values)
+{
+	FaxDemodulator demod(0);
+	connect(&demod,SIGNAL(data(int*,int)),SLOT(storeValues(int*,int)));
+	values.clear();
+	demodulated=&values;
+	int rate=demod.init(sampleRate,p);
+	for(size_t i=0; i<audio.size(); i+=1024) {
+		demod.newSamples(&audio[i],std::min<size_t>(audio.size()-i,
+							    1024));
+	}
+	demodulated=0;
+	return rate;
+}
+
+const std::vector<short>& TestSignal::samples(void) const
+{
+	return audio;
+}
+
+void TestSignal::store(short* samples, int n)
+{
+	for(int i=0; i<n; i++) {
+		audio.push_back(samples[i]/2);
+	}
+}
+
+void TestSignal::storeValues(int* values, int n)
+{
+	if(demodulated) {
+		demodulated->insert(demodulated->end(),values,values+n);
+	}
+}
+
+void TestSignal::finished(void)
+{
+	done=true;
+}
@@ -0,0 +1,90 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef TESTSIGNAL_HPP
+#define TESTSIGNAL_HPP
+
+#include <QImage>
+#include <QObject>
+#include <vector>
+#include "FaxParameters.hpp"
+
+/**
+ * Synthetic fax audio for the benchmarks and the regression tests. An
+ * image is sent through FaxTransmitter and FaxModulator like a real
+ * transmission, and the samples are kept in memory. Noise and a
+ * different clock of the transmitter can be added afterwards.
+ *
+ * The modulated signal has half of the full scale, so that there is room
+ * for the noise.
+ */
+
+class TestSignal : public QObject {
+	Q_OBJECT
+public:
+	TestSignal(QObject* parent);
+
+	/**
+	 * A test pattern with gray ramps, edges and fine detail.
+	 */
+	static QImage testImage(int width, int height, bool color);
+
+	/**
+	 * Replace the samples with a transmission of the image, including
+	 * APT tones and phasing lines.
+	 */
+	void modulate(const QImage& image, int sampleRate,
+		      const FaxParameters& p);
+
+	/**
+	 * Add white gaussian noise.
+	 *
+	 * \param snr is the ratio of signal to noise power in dB over the
+	 * whole bandwidth
+	 * \param seed makes the noise reproducible
+	 */
+	void addNoise(double snr, unsigned int seed);
+
+	/**
+	 * Resample the signal as if the clock of the transmitter was off.
+	 *
+	 * \param ppm is positive for a transmitter clock that is too fast
+	 */
+	void addDrift(double ppm);
+
+	/**
+	 * Demodulate the samples with a FaxDemodulator.
+	 *
+	 * \param values receives the demodulated values
+	 * \return the rate of the values
+	 */
+	int demodulate(int sampleRate, const FaxParameters& p,
+		       std::vector<int>& values);
+
+	const std::vector<short>& samples(void) const;
+private slots:
+	void store(short* samples, int n);
+	void storeValues(int* values, int n);
+	void finished(void);
+private:
+	std::vector<short> audio;
+	std::vector<int>* demodulated;
+	bool done;
+};
+
+#endif
@@ -0,0 +1,37 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef TIMESTAMP_HPP
+#define TIMESTAMP_HPP
+
+#include <QDateTime>
+#include <QString>
+
+/**
+ * File name for an image saved at time t, e.g.
+ * 2026-10-17-13-45-00.png. Quick save and the reception daemon use it.
+ *
+ * \param t is the time
+ * \param suffix is appended, e.g. ".png"
+ */
+inline QString timeStampName(const QDateTime& t, const QString& suffix)
+{
+	return t.toString("yyyy-MM-dd-hh-mm-ss")+suffix;
+}
+
+#endif
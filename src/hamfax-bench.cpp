@@ -0,0 +1,484 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+/**
+ * \file
+ *
+ * hamfax-bench main file. Times the DSP building blocks and the whole
+ * receive chain on synthetic fax signals and writes the results as JSON,
+ * so that the results of two versions can be compared. The settings are
+ * the built in defaults, not the ones of the configuration, so that the
+ * runs are reproducible.
+ */
+
+#include "config.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Error.hpp"
+#include "FaxDecoder.hpp"
+#include "FaxDemodulator.hpp"
+#include "FaxParameters.hpp"
+#include "FaxReceiver.hpp"
+#include "FirFilter.hpp"
+#include "FirKernels.hpp"
+#include "LookUpTable.hpp"
+#include "TestSignal.hpp"
+
+static int usage(void)
+{
+	std::fprintf(stderr,
+		     "usage: hamfax-bench [--quick] [--repeat N] "
+		     "[--compare <old.json>] [--tolerance P]\n"
+		     "The results are written to stdout as JSON. Every "
+		     "benchmark is run N times\n(default 3), the fastest run "
+		     "counts. With --compare the results are\nchecked "
+		     "against an older run, a benchmark that lost more than "
+		     "P percent\n(default 10) of its samples per second "
+		     "makes the exit status 2.\nEvery FIR kernel the CPU "
+		     "supports is timed and checked against the\nscalar "
+		     "kernel, a kernel with different results makes the "
+		     "exit status 3.\n");
+	return 1;
+}
+
+/**
+ * Something to be timed.
+ */
+
+class Benchmark {
+public:
+	virtual ~Benchmark(void) {}
+	virtual void run(void)=0;
+};
+
+static int repeat=3;
+static QJsonArray results;
+
+// Keep the fastest of the runs.
+
+static void measure(const QString& name, Benchmark& b, double samples,
+		    int images=0)
+{
+	double best=0;
+	for(int i=0; i<repeat; i++) {
+		QElapsedTimer timer;
+		timer.start();
+		b.run();
+		double t=timer.nsecsElapsed()/1e9;
+		if(i==0 || t<best) {
+			best=t;
+		}
+	}
+	QJsonObject o;
+	o["name"]=name;
+	o["samples"]=samples;
+	o["seconds"]=best;
+	o["samplesPerSecond"]=best>0 ? samples/best : 0.0;
+	if(images>0) {
+		o["imagesPerSecond"]=best>0 ? images/best : 0.0;
+	}
+	results.append(o);
+	std::fprintf(stderr,"%-32s %12.0f samples/s\n",
+		     name.toLocal8Bit().constData(),best>0 ? samples/best : 0);
+}
+
+class FirBench : public Benchmark {
+public:
+	FirBench(size_t taps, size_t n)
+		: filter(taps), in(n), out(n)
+	{
+		std::valarray<double> c(1.0/taps,taps);
+		filter.setCoeffs(c);
+		for(size_t i=0; i<n; i++) {
+			in[i]=(i*7919)%2000-1000;
+		}
+	}
+	void run(void)
+	{
+		for(size_t i=0; i<in.size(); i+=512) {
+			filter.filterBlock(&in[i],&out[i],
+					   std::min<size_t>(512,in.size()-i));
+		}
+	}
+private:
+	FirFilter<double> filter;
+	std::vector<double> in;
+	std::vector<double> out;
+};
+
+class LookUpBench : public Benchmark {
+public:
+	LookUpBench(size_t n)
+		: table(8192), n(n), sum(0)
+	{
+		for(size_t i=0; i<table.size(); i++) {
+			table[i]=i;
+		}
+		table.setIncrement(1717);
+	}
+	void run(void)
+	{
+		for(size_t i=0; i<n; i++) {
+			sum+=table.nextValue();
+		}
+	}
+private:
+	LookUpTable<int> table;
+	size_t n;
+	// keeps the loop from being optimized away
+	volatile int sum;
+};
+
+class DemodulatorBench : public Benchmark {
+public:
+	DemodulatorBench(const std::vector<short>& audio, int sampleRate,
+			 const FaxParameters& p)
+		: audio(audio), sampleRate(sampleRate), p(p), demod(0)
+	{
+	}
+	void run(void)
+	{
+		demod.init(sampleRate,p);
+		for(size_t i=0; i<audio.size(); i+=512) {
+			demod.newSamples(const_cast<short*>(&audio[i]),
+					 std::min<size_t>(512,audio.size()-i));
+		}
+	}
+private:
+	const std::vector<short>& audio;
+	int sampleRate;
+	FaxParameters p;
+	FaxDemodulator demod;
+};
+
+class ReceiverBench : public Benchmark {
+public:
+	ReceiverBench(const std::vector<int>& values, int rate,
+		      const FaxParameters& p)
+		: values(values), rate(rate), p(p), rx(0)
+	{
+		rx.setWidth(p.width());
+	}
+	void run(void)
+	{
+		rx.init(rate,p);
+		for(size_t i=0; i<values.size(); i+=512) {
+			rx.decode(const_cast<int*>(&values[i]),
+				  std::min<size_t>(512,values.size()-i));
+		}
+		rx.decode(0,0);
+	}
+private:
+	const std::vector<int>& values;
+	int rate;
+	FaxParameters p;
+	FaxReceiver rx;
+};
+
+class DecodeBench : public Benchmark {
+public:
+	DecodeBench(const std::vector<short>& audio, int sampleRate,
+		    const FaxParameters& p)
+		: audio(audio), sampleRate(sampleRate), p(p), decoder(0)
+	{
+	}
+	void run(void)
+	{
+		decoder.decodeSamples(&audio[0],audio.size(),sampleRate,p);
+	}
+private:
+	const std::vector<short>& audio;
+	int sampleRate;
+	FaxParameters p;
+	FaxDecoder decoder;
+};
+
+// A reception as in the end to end benchmarks.
+
+struct Case {
+	const char* name;
+	int sampleRate;
+	int lpm;
+	int ioc;
+	bool color;
+	bool fixedPoint;
+	double snr;       // dB, 0 for no noise
+	double drift;     // ppm
+};
+
+static const Case cases[]={
+	{ "lpm120-ioc576", 8000, 120, 576, false, false, 0, 0 },
+	{ "lpm60-ioc288", 11025, 60, 288, false, false, 0, 0 },
+	{ "lpm240-ioc288", 8000, 240, 288, false, false, 0, 0 },
+	{ "color", 8000, 120, 288, true, false, 0, 0 },
+	{ "fixed", 8000, 120, 576, false, true, 0, 0 },
+	{ "noise-10dB", 8000, 120, 576, false, false, 10, 0 },
+	{ "drift-50ppm", 8000, 120, 576, false, false, 0, 50 },
+	{ "rate-22050", 22050, 120, 576, false, false, 0, 0 },
+	{ "rate-44100", 44100, 120, 576, false, false, 0, 0 },
+	{ "rate-48000", 48000, 120, 576, false, false, 0, 0 }
+};
+
+static FaxParameters parameters(const Case& c)
+{
+	FaxParameters p;
+	p.lpm=c.lpm;
+	p.ioc=c.ioc;
+	p.color=c.color;
+	p.fixedPoint=c.fixedPoint;
+	// short APT tones, the benchmark is about the image
+	p.aptStartLength=2;
+	p.aptStopLength=2;
+	return p;
+}
+
+static void building(bool quick)
+{
+	size_t n=quick ? 1<<18 : 1<<21;
+	static const size_t taps[]={ 17, 65, 129 };
+	for(size_t i=0; i<sizeof(taps)/sizeof(taps[0]); i++) {
+		FirBench b(taps[i],n);
+		measure(QString("fir/%1").arg(static_cast<int>(taps[i])),b,n);
+	}
+	LookUpBench b(4*n);
+	measure("lookup",b,4*n);
+}
+
+static const char* const firKernelNames[]={ "scalar", "sse2", "avx2",
+					    "neon" };
+
+// Filter the same samples with all three kernel functions, a decimation
+// factor of 4 as in the demodulator.
+
+static void firKernelOutput(const std::vector<double>& x, size_t history,
+			    const std::vector<double>& c,
+			    std::vector<double>& out)
+{
+	size_t n=(x.size()-history)/2;
+	out.assign(2*n+2*n+n/2,0);
+	firBlock(&x[history],&c[0],c.size(),&out[0],2*n);
+	firBlockIQ(&x[history],&c[0],c.size(),&out[2*n],n);
+	firDecimateIQ(&x[history],&c[0],c.size(),&out[4*n],n/4,4);
+}
+
+// Times every FIR kernel this CPU has and compares its results with the
+// ones of the scalar kernel, which have to be bit-identical. Returns the
+// number of kernels that differ.
+
+static int firKernels(bool quick)
+{
+	const char* const selected=firKernelName();
+	size_t n=quick ? 1<<18 : 1<<21;
+	static const size_t taps[]={ 17, 65, 129 };
+	int differ=0;
+	for(size_t t=0; t<sizeof(taps)/sizeof(taps[0]); t++) {
+		const size_t history=2*taps[t];
+		std::vector<double> x(history+2*4096);
+		for(size_t i=0; i<x.size(); i++) {
+			x[i]=(i*7919)%2000-1000+0.1*(i%7);
+		}
+		std::vector<double> c(taps[t]);
+		for(size_t k=0; k<c.size(); k++) {
+			c[k]=std::sin(0.3*k+0.1)/taps[t];
+		}
+		std::vector<double> reference;
+		firSetKernel("scalar");
+		firKernelOutput(x,history,c,reference);
+		for(size_t k=0; k<sizeof(firKernelNames)
+			    /sizeof(firKernelNames[0]); k++) {
+			const char* name=firKernelNames[k];
+			if(!firSetKernel(name)) {
+				continue;
+			}
+			std::vector<double> out;
+			firKernelOutput(x,history,c,out);
+			if(std::memcmp(&out[0],&reference[0],
+				       out.size()*sizeof(double))!=0) {
+				std::fprintf(stderr,"fir/%d/%s differs from "
+					     "the scalar kernel\n",
+					     static_cast<int>(taps[t]),name);
+				differ++;
+			}
+			FirBench b(taps[t],n);
+			measure(QString("fir/%1/%2")
+				.arg(static_cast<int>(taps[t])).arg(name),b,n);
+		}
+	}
+	firSetKernel(selected);
+	return differ;
+}
+
+static void stages(bool quick)
+{
+	static const int rates[]={ 8000, 11025, 22050, 44100, 48000 };
+	int rows=quick ? 16 : 64;
+	for(size_t r=0; r<sizeof(rates)/sizeof(rates[0]); r++) {
+		FaxParameters p;
+		p.aptStartLength=p.aptStopLength=2;
+		TestSignal signal(0);
+		signal.modulate(TestSignal::testImage(p.width(),rows,false),
+				rates[r],p);
+		const std::vector<short>& audio=signal.samples();
+
+		FaxParameters fm=p;
+		DemodulatorBench fast(audio,rates[r],fm);
+		measure(QString("demodulator/fm/%1").arg(rates[r]),fast,
+			audio.size());
+		fm.fastDiscriminator=false;
+		DemodulatorBench table(audio,rates[r],fm);
+		measure(QString("demodulator/fm-table/%1").arg(rates[r]),table,
+			audio.size());
+		fm=p;
+		fm.fixedPoint=true;
+		DemodulatorBench fixed(audio,rates[r],fm);
+		measure(QString("demodulator/fm-fixed/%1").arg(rates[r]),fixed,
+			audio.size());
+		FaxParameters am=p;
+		am.fm=false;
+		DemodulatorBench amDemod(audio,rates[r],am);
+		measure(QString("demodulator/am/%1").arg(rates[r]),amDemod,
+			audio.size());
+
+		std::vector<int> values;
+		int rate=signal.demodulate(rates[r],p,values);
+		ReceiverBench rx(values,rate,p);
+		measure(QString("receiver/%1").arg(rates[r]),rx,values.size());
+	}
+}
+
+static void endToEnd(bool quick)
+{
+	int rows=quick ? 32 : 128;
+	for(size_t i=0; i<sizeof(cases)/sizeof(cases[0]); i++) {
+		const Case& c=cases[i];
+		FaxParameters p=parameters(c);
+		TestSignal signal(0);
+		signal.modulate(TestSignal::testImage(p.width(),rows,c.color),
+				c.sampleRate,p);
+		if(c.drift!=0) {
+			signal.addDrift(c.drift);
+		}
+		if(c.snr>0) {
+			signal.addNoise(c.snr,1);
+		}
+		DecodeBench b(signal.samples(),c.sampleRate,p);
+		measure(QString("decode/%1").arg(c.name),b,
+			signal.samples().size(),1);
+	}
+}
+
+// Returns the number of benchmarks that got slower than allowed.
+
+static int compare(const QString& fileName, double tolerance)
+{
+	QFile file(fileName);
+	if(!file.open(QIODevice::ReadOnly)) {
+		throw Error(QString("could not open %1").arg(fileName));
+	}
+	QJsonArray old=QJsonDocument::fromJson(file.readAll()).object()
+		["results"].toArray();
+	int slower=0;
+	for(int i=0; i<results.size(); i++) {
+		QJsonObject now=results[i].toObject();
+		for(int k=0; k<old.size(); k++) {
+			QJsonObject then=old[k].toObject();
+			if(then["name"]!=now["name"]
+			   || then["samplesPerSecond"].toDouble()<=0) {
+				continue;
+			}
+			double ratio=now["samplesPerSecond"].toDouble()
+				/then["samplesPerSecond"].toDouble();
+			bool bad=ratio<1.0-tolerance/100;
+			std::fprintf(stderr,"%-32s %6.2f%s\n",
+				     now["name"].toString().toLocal8Bit()
+				     .constData(),ratio,bad ? " slower" : "");
+			if(bad) {
+				slower++;
+			}
+		}
+	}
+	return slower;
+}
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+	QStringList args=app.arguments().mid(1);
+	bool quick=false;
+	QString old;
+	double tolerance=10;
+	while(!args.isEmpty()) {
+		bool ok=true;
+		if(args[0]=="--quick") {
+			quick=true;
+			args=args.mid(1);
+			continue;
+		}
+		if(args.size()<2) {
+			return usage();
+		}
+		if(args[0]=="--repeat") {
+			repeat=args[1].toInt(&ok);
+			ok=ok && repeat>0;
+		} else if(args[0]=="--compare") {
+			old=args[1];
+		} else if(args[0]=="--tolerance") {
+			tolerance=args[1].toDouble(&ok);
+		} else {
+			return usage();
+		}
+		if(!ok) {
+			return usage();
+		}
+		args=args.mid(2);
+	}
+	try {
+		building(quick);
+		int differ=firKernels(quick);
+		stages(quick);
+		endToEnd(quick);
+		QJsonObject root;
+		root["program"]=QString(PACKAGE_STRING);
+		root["quick"]=quick;
+		root["repeat"]=repeat;
+		root["results"]=results;
+		root["firKernel"]=QString(firKernelName());
+		std::fputs(QJsonDocument(root).toJson().constData(),stdout);
+		if(differ>0) {
+			return 3;
+		}
+		if(!old.isEmpty() && compare(old,tolerance)>0) {
+			return 2;
+		}
+	} catch(Error e) {
+		std::fprintf(stderr,"hamfax-bench: %s\n",
+			     e.getText().toLocal8Bit().constData());
+		return 1;
+	}
+	return 0;
+}
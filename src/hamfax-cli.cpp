@@ -0,0 +1,426 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/**
+ * \file
+ *
+ * hamfax-cli main file. Reception and transmission without any widgets,
+ * for scripts and machines without a display. The settings are read
+ * from the hamfax configuration, LPM and IOC can be given as options.
+ */
+
+#include "config.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QStringList>
+#include <cstdio>
+#include "BatchDecoder.hpp"
+#include "Channelizer.hpp"
+#include "Config.hpp"
+#include "Error.hpp"
+#include "FaxDaemon.hpp"
+#include "FaxDecoder.hpp"
+#include "FaxModulator.hpp"
+#include "FaxTransmitter.hpp"
+#include "File.hpp"
+#include "Sound.hpp"
+#ifdef USE_STATS
+#include "StageStats.hpp"
+#endif
+
+// "-d" instead of a file name stands for the sound device
+static const char* device="-d";
+
+static int usage(void)
+{
+	std::fprintf(stderr,
+		     "usage: hamfax-cli decode [--session <file>] [options] "
+		     "<input.au|-d> <output.png|output.pgm>\n"
+		     "       hamfax-cli render [options] <session> "
+		     "<output.png|output.pgm>\n"
+		     "       hamfax-cli encode [options] <image> <output.au|-d>\n"
+		     "       hamfax-cli batch [--jobs N] <output dir> "
+		     "[options] <input>... [[options] <input>...]\n"
+		     "       hamfax-cli daemon [--schedule <file>] "
+		     "[--sessions] [--max-minutes N]\n"
+		     "                         [--channels <carrier>,...] "
+		     "[options] <output dir>\n"
+		     "options: --lpm N  lines per minute\n"
+		     "         --ioc N  index of cooperation (204-576)\n"
+		     "         --kernel box|linear|sinc  pixel reconstruction\n"
+		     "In batch mode the options apply to the inputs after "
+		     "them. A session keeps\nthe samples of a reception, "
+		     "render draws it again with the LPM and IOC\nof the "
+		     "reception or the ones given.\n"
+		     "The daemon receives from the sound device until it is "
+		     "killed and saves\nevery image with the time (UTC) in "
+		     "its name. Schedule lines are\n"
+		     "  <begin hh:mm> <end hh:mm> <name> [options]\n"
+		     "in UTC, the images of an entry are named after it and "
+		     "received with its\noptions, the options of the command "
+		     "line apply outside the entries. With --channels every "
+		     "carrier frequency\n(Hz) of the sound card is received "
+		     "on its own, the images get the carrier\nin front of "
+		     "their names.\n");
+#ifdef USE_STATS
+	std::fprintf(stderr,"decode --stats <file|-> writes the counters of "
+		     "the receive chain as JSON.\n");
+#endif
+	return 1;
+}
+
+// Take the options at the front of args.
+
+static bool takeOptions(QStringList& args, FaxParameters& p)
+{
+	static const char* kernels[]={"box","linear","sinc"};
+	while(args.size()>=2 && args[0].startsWith("--")) {
+		if(args[0]=="--kernel") {
+			int i=0;
+			while(i<3 && args[1]!=kernels[i]) {
+				i++;
+			}
+			if(i==3) {
+				return false;
+			}
+			p.kernel=i;
+			args=args.mid(2);
+			continue;
+		}
+		bool ok;
+		int value=args[1].toInt(&ok);
+		if(!ok) {
+			return false;
+		}
+		if(args[0]=="--lpm" && value>0) {
+			p.lpm=value;
+		} else if(args[0]=="--ioc" && value>=204 && value<=576) {
+			p.ioc=value;
+		} else {
+			return false;
+		}
+		args=args.mid(2);
+	}
+	return true;
+}
+
+static int decode(QCoreApplication& app, QStringList args)
+{
+	QString session;
+	QString stats;
+	while(args.size()>=2) {
+		if(args[0]=="--session") {
+			session=args[1];
+#ifdef USE_STATS
+		} else if(args[0]=="--stats") {
+			stats=args[1];
+#endif
+		} else {
+			break;
+		}
+		args=args.mid(2);
+	}
+	FaxParameters p=Config::instance().faxParameters();
+	if(!takeOptions(args,p) || args.size()!=2) {
+		return usage();
+	}
+	FaxDecoder decoder(0);
+	if(args[0]==device) {
+		QObject::connect(&decoder,SIGNAL(finished()),&app,SLOT(quit()));
+		decoder.startSound(p);
+		app.exec();
+	} else {
+		decoder.decodeFile(args[0],p);
+		std::fprintf(stderr,"decoded %.1f s of audio, %.1f times "
+			     "real time\n",decoder.audioTime(),decoder.speed());
+	}
+	if(!decoder.save(args[1])) {
+		throw Error(QString("could not save %1").arg(args[1]));
+	}
+	if(!session.isEmpty() && !decoder.saveSession(session)) {
+		throw Error(QString("could not save %1").arg(session));
+	}
+#ifdef USE_STATS
+	if(stats=="-") {
+		std::fputs(StageStats::dump().constData(),stdout);
+	} else if(!stats.isEmpty()) {
+		QFile file(stats);
+		if(!file.open(QIODevice::WriteOnly)
+		   || file.write(StageStats::dump())<0) {
+			throw Error(QString("could not save %1").arg(stats));
+		}
+	}
+#endif
+	return 0;
+}
+
+static int render(QStringList args)
+{
+	// 0 keeps what the session says
+	FaxParameters p;
+	p.lpm=p.ioc=0;
+	p.kernel=Config::instance().faxParameters().kernel;
+	if(!takeOptions(args,p) || args.size()!=2) {
+		return usage();
+	}
+	FaxDecoder decoder(0);
+	if(!decoder.renderSession(args[0],p.lpm,p.ioc>0 ? p.width() : 0,
+				  p.kernel)) {
+		throw Error(QString("%1 is no session file").arg(args[0]));
+	}
+	if(!decoder.save(args[1])) {
+		throw Error(QString("could not save %1").arg(args[1]));
+	}
+	return 0;
+}
+
+static int batch(QStringList args)
+{
+	int threads=0;
+	if(args.size()>=2 && args[0]=="--jobs") {
+		bool ok;
+		threads=args[1].toInt(&ok);
+		if(!ok || threads<1) {
+			return usage();
+		}
+		args=args.mid(2);
+	}
+	if(args.size()<2) {
+		return usage();
+	}
+	QDir outputDir(args.takeFirst());
+	FaxParameters p=Config::instance().faxParameters();
+	BatchDecoder decoder(threads);
+	while(!args.isEmpty()) {
+		if(!takeOptions(args,p) || args.isEmpty()) {
+			return usage();
+		}
+		// the same file may be decoded with different settings
+		QString input=args.takeFirst();
+		QString name=QString("%1-lpm%2-ioc%3.png")
+			.arg(QFileInfo(input).completeBaseName())
+			.arg(p.lpm).arg(p.ioc);
+		decoder.add(input,outputDir.filePath(name),p);
+	}
+	QElapsedTimer time;
+	time.start();
+	int failed=decoder.run();
+	double audio=0;
+	for(int i=0; i<decoder.jobs().size(); i++) {
+		const BatchDecoder::Job& job=decoder.jobs()[i];
+		if(job.ok) {
+			std::fprintf(stderr,"%s: %.1f s of audio, %.1f times "
+				     "real time\n",
+				     job.output.toLocal8Bit().constData(),
+				     job.audioTime,job.speed);
+			audio+=job.audioTime;
+		} else {
+			std::fprintf(stderr,"%s: %s\n",
+				     job.input.toLocal8Bit().constData(),
+				     job.error.toLocal8Bit().constData());
+		}
+	}
+	double seconds=time.elapsed()/1000.0;
+	std::fprintf(stderr,"%d files, %.1f s of audio in %.1f s, %.1f times "
+		     "real time\n",decoder.jobs().size(),audio,seconds,
+		     seconds>0 ? audio/seconds : 0);
+	return failed>0 ? 1 : 0;
+}
+
+// One entry per line, empty lines and lines starting with # are skipped.
+
+static bool readSchedule(const QString& fileName, const FaxParameters& p,
+			 FaxDaemon& daemon)
+{
+	QFile file(fileName);
+	if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		throw Error(QString("could not open %1").arg(fileName));
+	}
+	int number=0;
+	while(!file.atEnd()) {
+		QString line=QString::fromLocal8Bit(file.readLine()).simplified();
+		number++;
+		if(line.isEmpty() || line.startsWith("#")) {
+			continue;
+		}
+		QStringList fields=line.split(' ');
+		FaxParameters entry=p;
+		QTime begin;
+		QTime end;
+		if(fields.size()>=3) {
+			begin=QTime::fromString(fields[0],"hh:mm");
+			end=QTime::fromString(fields[1],"hh:mm");
+		}
+		QStringList options=fields.mid(3);
+		if(!begin.isValid() || !end.isValid()
+		   || !takeOptions(options,entry) || !options.isEmpty()) {
+			std::fprintf(stderr,"%s:%d: invalid schedule entry\n",
+				     fileName.toLocal8Bit().constData(),number);
+			return false;
+		}
+		daemon.addSchedule(begin,end,fields[2],entry);
+	}
+	return true;
+}
+
+static int daemon(QCoreApplication& app, QStringList args)
+{
+	QString schedule;
+	bool sessions=false;
+	int maxMinutes=30;
+	QVector<int> carriers;
+	while(!args.isEmpty()) {
+		if(args.size()>=2 && args[0]=="--channels") {
+			QStringList list=args[1].split(',');
+			for(int i=0; i<list.size(); i++) {
+				bool ok;
+				carriers.append(list[i].toInt(&ok));
+				if(!ok) {
+					return usage();
+				}
+			}
+			args=args.mid(2);
+		} else if(args.size()>=2 && args[0]=="--schedule") {
+			schedule=args[1];
+			args=args.mid(2);
+		} else if(args[0]=="--sessions") {
+			sessions=true;
+			args=args.mid(1);
+		} else if(args.size()>=2 && args[0]=="--max-minutes") {
+			bool ok;
+			maxMinutes=args[1].toInt(&ok);
+			if(!ok || maxMinutes<1) {
+				return usage();
+			}
+			args=args.mid(2);
+		} else {
+			break;
+		}
+	}
+	FaxParameters p=Config::instance().faxParameters();
+	if(!takeOptions(args,p) || args.size()!=1) {
+		return usage();
+	}
+	if(carriers.isEmpty()) {
+		FaxDaemon faxDaemon(args[0],p,0);
+		if(!schedule.isEmpty() && !readSchedule(schedule,p,faxDaemon)) {
+			return 1;
+		}
+		faxDaemon.setSessions(sessions);
+		faxDaemon.setMaxMinutes(maxMinutes);
+		faxDaemon.start();
+		return app.exec();
+	}
+
+	// one daemon per channel, the channelizer has to fill the buffers
+	// before the daemons read them
+	Sound sound(0);
+	int sampleRate=sound.startInput();
+	Channelizer channelizer(&sound.captureBuffer(),carriers.size());
+	QMetaObject::invokeMethod(&channelizer,"start",
+				  Qt::BlockingQueuedConnection,
+				  Q_ARG(int,sampleRate));
+	for(int i=0; i<carriers.size(); i++) {
+		FaxParameters c=p;
+		c.carrier=carriers[i];
+		FaxDaemon* faxDaemon=new FaxDaemon(args[0],c,&app);
+		if(!schedule.isEmpty() && !readSchedule(schedule,c,*faxDaemon)) {
+			return 1;
+		}
+		faxDaemon->setSource(channelizer.channel(i),sampleRate);
+		faxDaemon->setPrefix(QString("%1Hz").arg(carriers[i]));
+		faxDaemon->setSessions(sessions);
+		faxDaemon->setMaxMinutes(maxMinutes);
+		faxDaemon->start();
+	}
+	return app.exec();
+}
+
+static int encode(QCoreApplication& app, QStringList args)
+{
+	FaxParameters p=Config::instance().faxParameters();
+	if(!takeOptions(args,p) || args.size()!=2) {
+		return usage();
+	}
+	QImage image(args[0]);
+	if(image.isNull()) {
+		throw Error(QString("could not load %1").arg(args[0]));
+	}
+	FaxTransmitter transmitter(0);
+	FaxModulator modulator(0);
+	File file(0);
+	Sound sound(0);
+	int sampleRate;
+	QObject::connect(&transmitter,SIGNAL(data(double*,int)),
+			 &modulator,SLOT(modulate(double*,int)));
+	if(args[1]==device) {
+		sampleRate=sound.startOutput();
+		QObject::connect(&sound,SIGNAL(spaceLeft(int)),
+				 &transmitter,SLOT(doNext(int)));
+		QObject::connect(&modulator,SIGNAL(data(short*,int)),
+				 &sound,SLOT(write(short*,int)));
+		QObject::connect(&transmitter,SIGNAL(end()),&sound,SLOT(end()));
+		QObject::connect(&sound,SIGNAL(deviceClosed()),
+				 &app,SLOT(quit()));
+	} else {
+		sampleRate=file.startOutput(args[1]);
+		QObject::connect(&file,SIGNAL(next(int)),
+				 &transmitter,SLOT(doNext(int)));
+		QObject::connect(&modulator,SIGNAL(data(short*,int)),
+				 &file,SLOT(write(short*,int)));
+		QObject::connect(&transmitter,SIGNAL(end()),&app,SLOT(quit()));
+	}
+	transmitter.setImage(image.convertToFormat(QImage::Format_RGB32));
+	transmitter.start(sampleRate,p);
+	modulator.init(sampleRate,p);
+	app.exec();
+	file.end();
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+	QStringList args=app.arguments().mid(1);
+	if(args.isEmpty()) {
+		return usage();
+	}
+	try {
+		QString command=args.takeFirst();
+		if(command=="decode") {
+			return decode(app,args);
+		} else if(command=="encode") {
+			return encode(app,args);
+		} else if(command=="batch") {
+			return batch(args);
+		} else if(command=="render") {
+			return render(args);
+		} else if(command=="daemon") {
+			return daemon(app,args);
+		}
+		return usage();
+	} catch(Error e) {
+		std::fprintf(stderr,"hamfax-cli: %s\n",
+			     e.getText().toLocal8Bit().constData());
+		return 1;
+	}
+}
@@ -0,0 +1,658 @@
+// hamfax -- an application for sending and receiving amateur radio facsimiles
+// Copyright (C) 2026
+// Christof Schmitt, DH1CS <cschmitt@users.sourceforge.net>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+/**
+ * \file
+ *
+ * hamfax-regress main file. Sends a test pattern through FaxTransmitter,
+ * FaxModulator, FaxDemodulator and FaxReceiver with several sample
+ * rates and modulation settings. Every case is received twice from the
+ * same signal: once with the settings of the case and once by the
+ * reference path, the floating point demodulator with the table
+ * discriminator and the scalar FIR kernels. The two images are compared
+ * by PSNR and SSIM, so the fast, fixed point and SIMD variants have to
+ * give the image of the reference path. A difference of one sample in
+ * the start of the lines already costs 10 dB, so the image is first
+ * moved by up to a pixel to fit the other one best. A wrong start of
+ * the lines or a wrong LPM still leaves far less than the limits. The
+ * reference image itself has to resemble the test pattern, which catches
+ * a reception that fails as a whole. The time the receiver needs to lock on the phasing lines is
+ * checked against the reference as well. The redraw of a saved session
+ * on the thread pool has to give the image drawn while receiving.
+ *
+ * The images can also be compared with golden images of a known good
+ * version, which are written with --update. They are PNG files named
+ * after the cases, the lock times go to golden.json in the same
+ * directory. The golden images have to be there unless --no-golden is
+ * given, which only compares with the reference path.
+ *
+ * The faster demodulators are also compared sample by sample with the
+ * floating point path of FaxDemodulator and its table discriminator,
+ * which no golden image can show.
+ */
+
+#include "config.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTemporaryFile>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Error.hpp"
+#include "FaxDecoder.hpp"
+#include "FaxParameters.hpp"
+#include "FirKernels.hpp"
+#include "TestSignal.hpp"
+
+static int usage(void)
+{
+	std::fprintf(stderr,
+		     "usage: hamfax-regress [--update | --no-golden] "
+		     "[--case <name>] [--psnr dB]\n"
+		     "                      [--ssim S] [--source-psnr dB] "
+		     "<golden dir>\n"
+		     "Every case must reach the PSNR (default 25 dB) and the "
+		     "SSIM (default 0.9)\nagainst the image of the reference "
+		     "path and against its golden image, after\nmoving it by "
+		     "up to a pixel to fit best, and lock on the phasing lines "
+		     "at\nmost two lines later than both. Without --no-golden "
+		     "every case needs a\ngolden image. The reference image "
+		     "must reach a PSNR of --source-psnr\n(default 12 dB) "
+		     "against the test pattern. --update writes the golden "
+		     "images\nof the cases that pass, run it on a version that "
+		     "is known to work.\n"
+		     "The demodulated values of the fast FM discriminator and "
+		     "of the fixed point\ndemodulator may differ by at most "
+		     "one grey level from the ones of the\nfloating point "
+		     "demodulator with the table discriminator. A saved "
+		     "session must be redrawn\nto the image drawn while "
+		     "receiving.\n"
+		     "A report goes to stdout as JSON, the exit status is 2 "
+		     "if a case failed.\n");
+	return 1;
+}
+
+// A reception through the whole chain.
+
+struct Case {
+	const char* name;
+	int sampleRate;
+	int lpm;
+	int ioc;
+	bool color;
+	bool fm;
+	bool fastDiscriminator;
+	bool fixedPoint;
+	double snr;       // dB, 0 for no noise
+	double drift;     // ppm
+};
+
+static const Case cases[]={
+	{ "fm-8000", 8000, 120, 288, false, true, true, false, 0, 0 },
+	{ "fm-11025", 11025, 120, 288, false, true, true, false, 0, 0 },
+	{ "fm-22050", 22050, 120, 288, false, true, true, false, 0, 0 },
+	{ "fm-44100", 44100, 120, 288, false, true, true, false, 0, 0 },
+	{ "fm-48000", 48000, 120, 288, false, true, true, false, 0, 0 },
+	// only the FIR kernels differ from the reference path
+	{ "fm-table-8000", 8000, 120, 288, false, true, false, false, 0, 0 },
+	{ "fm-fixed-8000", 8000, 120, 288, false, true, true, true, 0, 0 },
+	{ "fm-fixed-44100", 44100, 120, 288, false, true, true, true, 0, 0 },
+	{ "am-8000", 8000, 120, 288, false, false, true, false, 0, 0 },
+	{ "am-44100", 44100, 120, 288, false, false, true, false, 0, 0 },
+	{ "lpm60-ioc576", 11025, 60, 576, false, true, true, false, 0, 0 },
+	{ "lpm240", 8000, 240, 288, false, true, true, false, 0, 0 },
+	{ "color", 8000, 120, 288, true, true, true, false, 0, 0 },
+	{ "noise-20dB", 8000, 120, 288, false, true, true, false, 20, 0 },
+	{ "drift-20ppm", 8000, 120, 288, false, true, true, false, 0, 20 }
+};
+
+static FaxParameters parameters(const Case& c)
+{
+	FaxParameters p;
+	p.lpm=c.lpm;
+	p.ioc=c.ioc;
+	p.color=c.color;
+	p.fm=c.fm;
+	p.fastDiscriminator=c.fastDiscriminator;
+	p.fixedPoint=c.fixedPoint;
+	p.aptStartLength=2;
+	p.aptStopLength=2;
+	return p;
+}
+
+// A demodulator that has to give the same values as the floating point
+// path of FaxDemodulator with the table discriminator, within one grey
+// level.
+
+struct DemodulatorCase {
+	const char* name;
+	int sampleRate;
+	bool fm;
+	bool fixedPoint;
+};
+
+static const DemodulatorCase demodulatorCases[]={
+	{ "demod-fast-8000", 8000, true, false },
+	{ "demod-fast-11025", 11025, true, false },
+	{ "demod-fast-22050", 22050, true, false },
+	{ "demod-fast-44100", 44100, true, false },
+	{ "demod-fast-48000", 48000, true, false },
+	{ "demod-fixed-8000", 8000, true, true },
+	{ "demod-fixed-11025", 11025, true, true },
+	{ "demod-fixed-44100", 44100, true, true },
+	{ "demod-fixed-48000", 48000, true, true },
+	{ "demod-fixed-am-8000", 8000, false, true },
+	{ "demod-fixed-am-44100", 44100, false, true }
+};
+
+static int compareDemodulators(const QString& only, QJsonArray& report)
+{
+	int failed=0;
+	for(size_t i=0; i<sizeof(demodulatorCases)
+		    /sizeof(demodulatorCases[0]); i++) {
+		const DemodulatorCase& c=demodulatorCases[i];
+		if(!only.isEmpty() && only!=c.name) {
+			continue;
+		}
+		FaxParameters p;
+		p.aptStartLength=2;
+		p.aptStopLength=2;
+		p.fm=c.fm;
+		TestSignal signal(0);
+		signal.modulate(TestSignal::testImage(p.width(),48,false),
+				c.sampleRate,p);
+		FaxParameters table=p;
+		table.fastDiscriminator=false;
+		p.fixedPoint=c.fixedPoint;
+		std::vector<int> expected;
+		signal.demodulate(c.sampleRate,table,expected);
+		std::vector<int> values;
+		signal.demodulate(c.sampleRate,p,values);
+
+		int maxDiff=0;
+		size_t differ=0;
+		size_t n=std::min(values.size(),expected.size());
+		for(size_t k=0; k<n; k++) {
+			int d=std::abs(values[k]-expected[k]);
+			maxDiff=std::max(maxDiff,d);
+			if(d>0) {
+				differ++;
+			}
+		}
+		QString problem;
+		if(values.size()!=expected.size()) {
+			problem="length differs";
+		} else if(maxDiff>1) {
+			problem="values differ";
+		}
+		QJsonObject o;
+		o["name"]=QString(c.name);
+		o["values"]=static_cast<double>(n);
+		o["maxDifference"]=maxDiff;
+		o["differentValues"]=n>0 ? static_cast<double>(differ)/n
+			: 0.0;
+		o["ok"]=problem.isEmpty();
+		if(!problem.isEmpty()) {
+			o["problem"]=problem;
+			failed++;
+		}
+		report.append(o);
+		std::fprintf(stderr,"%-20s max diff %d, %.1f%% differ %s\n",
+			     c.name,maxDiff,n>0 ? 100.0*differ/n : 0.0,
+			     problem.isEmpty() ? "ok"
+			     : problem.toLocal8Bit().constData());
+	}
+	return failed;
+}
+
+// Over all channels of the area both images have, 99 dB for equal
+// images.
+
+static double psnr(const QImage& a, const QImage& b)
+{
+	int w=std::min(a.width(),b.width());
+	int h=std::min(a.height(),b.height());
+	double sum=0;
+	for(int r=0; r<h; r++) {
+		for(int c=0; c<w; c++) {
+			QRgb x=a.pixel(c,r);
+			QRgb y=b.pixel(c,r);
+			int d[3]={ qRed(x)-qRed(y), qGreen(x)-qGreen(y),
+				   qBlue(x)-qBlue(y) };
+			sum+=d[0]*d[0]+d[1]*d[1]+d[2]*d[2];
+		}
+	}
+	if(w<=0 || h<=0) {
+		return 0;
+	}
+	double mse=sum/(3.0*w*h);
+	return mse>0 ? 10*std::log10(255*255/mse) : 99.0;
+}
+
+// The image moved to the left by shift pixels, interpolated linearly.
+
+static QImage moved(const QImage& image, double shift)
+{
+	QImage out=image.convertToFormat(QImage::Format_RGB32);
+	const int w=image.width();
+	if(w<2) {
+		return out;
+	}
+	for(int r=0; r<image.height(); r++) {
+		for(int c=0; c<w; c++) {
+			double x=std::min(std::max(c+shift,0.0),w-1.0);
+			int k=std::min(static_cast<int>(x),w-2);
+			double f=x-k;
+			QRgb a=image.pixel(k,r);
+			QRgb b=image.pixel(k+1,r);
+			out.setPixel(c,r,qRgb(
+				qRound(qRed(a)*(1-f)+qRed(b)*f),
+				qRound(qGreen(a)*(1-f)+qGreen(b)*f),
+				qRound(qBlue(a)*(1-f)+qBlue(b)*f)));
+		}
+	}
+	return out;
+}
+
+// The image moved by the eighth of a pixel within one pixel that gives
+// the best PSNR against reference. shift gets how far it was moved.
+
+static QImage aligned(const QImage& image, const QImage& reference,
+		      double& shift)
+{
+	QImage best=image;
+	double bestDb=-1;
+	shift=0;
+	for(int i=-8; i<=8; i++) {
+		QImage m=moved(image,i/8.0);
+		double db=psnr(m,reference);
+		if(db>bestDb) {
+			bestDb=db;
+			best=m;
+			shift=i/8.0;
+		}
+	}
+	return best;
+}
+
+// The best PSNR of the test pattern against the rows of the image it
+// fits, the received image has a few more rows.
+
+static double sourcePsnr(const QImage& image, const QImage& source)
+{
+	double best=0;
+	for(int r=0; r==0 || r+source.height()<=image.height(); r++) {
+		best=std::max(best,psnr(image.copy(0,r,image.width(),
+						   source.height()),source));
+	}
+	return best;
+}
+
+// Mean SSIM of the gray values in windows of 8x8 pixels, moved by 4
+// pixels.
+
+static double ssim(const QImage& a, const QImage& b)
+{
+	const double c1=(0.01*255)*(0.01*255);
+	const double c2=(0.03*255)*(0.03*255);
+	const int size=8;
+	int w=std::min(a.width(),b.width());
+	int h=std::min(a.height(),b.height());
+	double sum=0;
+	int windows=0;
+	for(int r=0; r+size<=h; r+=size/2) {
+		for(int c=0; c+size<=w; c+=size/2) {
+			double sa=0, sb=0, saa=0, sbb=0, sab=0;
+			for(int i=r; i<r+size; i++) {
+				for(int k=c; k<c+size; k++) {
+					double x=qGray(a.pixel(k,i));
+					double y=qGray(b.pixel(k,i));
+					sa+=x;
+					sb+=y;
+					saa+=x*x;
+					sbb+=y*y;
+					sab+=x*y;
+				}
+			}
+			const double n=size*size;
+			double ma=sa/n, mb=sb/n;
+			double va=saa/n-ma*ma, vb=sbb/n-mb*mb;
+			double cov=sab/n-ma*mb;
+			sum+=(2*ma*mb+c1)*(2*cov+c2)
+				/((ma*ma+mb*mb+c1)*(va+vb+c2));
+			windows++;
+		}
+	}
+	return windows>0 ? sum/windows : 0;
+}
+
+static QJsonObject readGolden(const QDir& dir)
+{
+	QFile file(dir.filePath("golden.json"));
+	if(!file.open(QIODevice::ReadOnly)) {
+		return QJsonObject();
+	}
+	return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+static void writeGolden(const QDir& dir, const QJsonObject& golden)
+{
+	QFile file(dir.filePath("golden.json"));
+	if(!file.open(QIODevice::WriteOnly)
+	   || file.write(QJsonDocument(golden).toJson())<0) {
+		throw Error(QString("could not save %1")
+			    .arg(file.fileName()));
+	}
+}
+
+// One reception of a case.
+
+struct Reception {
+	QImage image;
+	double lock;      // seconds from the end of the APT start tone
+	double start;
+};
+
+static Reception receive(const TestSignal& signal, int sampleRate,
+			 const FaxParameters& p)
+{
+	FaxDecoder decoder(0);
+	decoder.decodeSamples(&signal.samples()[0],signal.samples().size(),
+			      sampleRate,p);
+	Reception r;
+	r.image=decoder.getImage();
+	// the phasing lines start after the APT start tone
+	r.lock=decoder.eventTime(FaxSession::PHASING);
+	r.start=decoder.eventTime(FaxSession::IMAGE);
+	if(r.lock>=0) {
+		r.lock-=p.aptStartLength;
+	}
+	if(r.start>=0) {
+		r.start-=p.aptStartLength;
+	}
+	return r;
+}
+
+// The floating point demodulator with the table discriminator and the
+// scalar FIR kernels, which all variants are compared with.
+
+static Reception receiveReference(const TestSignal& signal, int sampleRate,
+				  FaxParameters p)
+{
+	p.fastDiscriminator=false;
+	p.fixedPoint=false;
+	const char* kernel=firKernelName();
+	firSetKernel("scalar");
+	Reception r=receive(signal,sampleRate,p);
+	firSetKernel(kernel);
+	return r;
+}
+
+// The redraw of a saved session runs on the threads of the redraw pool
+// and has to give the image drawn while receiving. Slant tracking would
+// change the LPM between the first rows and the redraw, so it is off.
+
+static const int redrawRates[]={ 8000, 44100 };
+
+static int compareRedraw(const QString& only, double minPsnr,
+			 double minSsim, QJsonArray& report)
+{
+	int failed=0;
+	for(size_t i=0; i<sizeof(redrawRates)/sizeof(redrawRates[0]); i++) {
+		QString name=QString("redraw-%1").arg(redrawRates[i]);
+		if(!only.isEmpty() && only!=name) {
+			continue;
+		}
+		FaxParameters p;
+		p.aptStartLength=2;
+		p.aptStopLength=2;
+		p.slantTracking=false;
+		TestSignal signal(0);
+		signal.modulate(TestSignal::testImage(p.width(),48,false),
+				redrawRates[i],p);
+		FaxDecoder live(0);
+		live.decodeSamples(&signal.samples()[0],
+				   signal.samples().size(),redrawRates[i],p);
+		QTemporaryFile session;
+		if(!session.open()) {
+			throw Error("could not create a temporary file");
+		}
+		session.close();
+		FaxDecoder redrawn(0);
+		QString problem;
+		double db=0, s=0;
+		if(!live.saveSession(session.fileName())
+		   || !redrawn.renderSession(session.fileName(),0,p.width(),
+					     p.kernel)) {
+			problem="session not saved";
+		} else {
+			db=psnr(redrawn.getImage(),live.getImage());
+			s=ssim(redrawn.getImage(),live.getImage());
+			if(redrawn.getImage().size()!=live.getImage().size()) {
+				problem="size differs";
+			} else if(db<minPsnr || s<minSsim) {
+				problem="image differs";
+			}
+		}
+		QJsonObject o;
+		o["name"]=name;
+		o["psnr"]=db;
+		o["ssim"]=s;
+		o["ok"]=problem.isEmpty();
+		if(!problem.isEmpty()) {
+			o["problem"]=problem;
+			failed++;
+		}
+		report.append(o);
+		std::fprintf(stderr,"%-16s psnr %5.1f dB ssim %.3f %s\n",
+			     name.toLocal8Bit().constData(),db,s,
+			     problem.isEmpty() ? "ok"
+			     : problem.toLocal8Bit().constData());
+	}
+	return failed;
+}
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+	QStringList args=app.arguments().mid(1);
+	bool update=false;
+	bool noGolden=false;
+	QString only;
+	double minPsnr=25;
+	double minSsim=0.9;
+	double minSourcePsnr=12;
+	while(args.size()>1) {
+		bool ok=true;
+		if(args[0]=="--update") {
+			update=true;
+			args=args.mid(1);
+			continue;
+		}
+		if(args[0]=="--no-golden") {
+			noGolden=true;
+			args=args.mid(1);
+			continue;
+		}
+		if(args.size()<3) {
+			return usage();
+		}
+		if(args[0]=="--case") {
+			only=args[1];
+		} else if(args[0]=="--psnr") {
+			minPsnr=args[1].toDouble(&ok);
+		} else if(args[0]=="--ssim") {
+			minSsim=args[1].toDouble(&ok);
+		} else if(args[0]=="--source-psnr") {
+			minSourcePsnr=args[1].toDouble(&ok);
+		} else {
+			return usage();
+		}
+		if(!ok) {
+			return usage();
+		}
+		args=args.mid(2);
+	}
+	if(args.size()!=1 || (update && noGolden)) {
+		return usage();
+	}
+	QDir dir(args[0]);
+	try {
+		if(update && !dir.mkpath(".")) {
+			throw Error(QString("could not create %1")
+				    .arg(args[0]));
+		}
+		QJsonObject golden=readGolden(dir);
+		if(!update && !noGolden && golden.isEmpty()) {
+			throw Error(QString("no golden images in %1, make "
+					    "them with --update on a version "
+					    "that is known to work or use "
+					    "--no-golden").arg(args[0]));
+		}
+		QJsonArray report;
+		int failed=0;
+		for(size_t i=0; i<sizeof(cases)/sizeof(cases[0]); i++) {
+			const Case& c=cases[i];
+			if(!only.isEmpty() && only!=c.name) {
+				continue;
+			}
+			FaxParameters p=parameters(c);
+			QImage source=TestSignal::testImage(p.width(),48,
+							    c.color);
+			TestSignal signal(0);
+			signal.modulate(source,c.sampleRate,p);
+			if(c.drift!=0) {
+				signal.addDrift(c.drift);
+			}
+			if(c.snr>0) {
+				signal.addNoise(c.snr,1);
+			}
+			Reception rx=receive(signal,c.sampleRate,p);
+			Reception ref=receiveReference(signal,c.sampleRate,p);
+			const QImage& image=rx.image;
+			const double line=60.0/c.lpm;
+
+			QJsonObject o;
+			o["name"]=QString(c.name);
+			o["width"]=image.width();
+			o["height"]=image.height();
+			o["lockTime"]=rx.lock;
+			o["imageTime"]=rx.start;
+			o["referenceLockTime"]=ref.lock;
+			double sourceDb=sourcePsnr(ref.image,source);
+			o["sourcePsnr"]=sourceDb;
+			double shift;
+			QImage fit=aligned(image,ref.image,shift);
+			double db=psnr(fit,ref.image);
+			double s=ssim(fit,ref.image);
+			o["referencePsnr"]=db;
+			o["referenceSsim"]=s;
+			o["referenceShift"]=shift;
+
+			QString problem;
+			if(rx.lock<0 || rx.start<0 || ref.lock<0
+			   || ref.start<0) {
+				problem="no phasing";
+			} else if(sourceDb<minSourcePsnr) {
+				problem="reference differs from pattern";
+			} else if(image.size()!=ref.image.size()) {
+				problem="size differs from reference";
+			} else if(db<minPsnr || s<minSsim) {
+				problem="image differs from reference";
+			} else if(rx.lock>ref.lock+2*line) {
+				problem="late phasing lock";
+			}
+
+			QString goldenName=dir.filePath(QString("%1.png")
+							.arg(c.name));
+			if(!problem.isEmpty() || noGolden) {
+				// no golden image from a failed case
+			} else if(update) {
+				if(!image.save(goldenName)) {
+					throw Error(QString("could not save %1")
+						    .arg(goldenName));
+				}
+				QJsonObject g;
+				g["lockTime"]=rx.lock;
+				golden[c.name]=g;
+			} else {
+				QImage reference(goldenName);
+				double goldenLock=golden.value(c.name)
+					.toObject().value("lockTime")
+					.toDouble(-1);
+				if(reference.isNull()) {
+					problem="no golden image";
+				} else {
+					fit=aligned(image,reference,shift);
+					db=psnr(fit,reference);
+					s=ssim(fit,reference);
+					o["goldenPsnr"]=db;
+					o["goldenSsim"]=s;
+					o["goldenShift"]=shift;
+					if(image.size()!=reference.size()) {
+						problem="size differs from "
+							"golden image";
+					} else if(db<minPsnr || s<minSsim) {
+						problem="image differs from "
+							"golden image";
+					} else if(goldenLock>=0
+						  && rx.lock>goldenLock
+						  +2*line) {
+						problem="late phasing lock";
+					}
+				}
+			}
+			o["ok"]=problem.isEmpty();
+			if(!problem.isEmpty()) {
+				o["problem"]=problem;
+				failed++;
+			}
+			report.append(o);
+			std::fprintf(stderr,"%-16s psnr %5.1f dB ssim %.3f "
+				     "pattern %5.1f dB lock %5.2f s %s\n",
+				     c.name,db,s,sourceDb,rx.lock,
+				     problem.isEmpty() ? "ok"
+				     : problem.toLocal8Bit().constData());
+		}
+		if(update) {
+			writeGolden(dir,golden);
+		}
+		failed+=compareDemodulators(only,report);
+		failed+=compareRedraw(only,minPsnr,minSsim,report);
+		QJsonObject root;
+		root["program"]=QString(PACKAGE_STRING);
+		root["firKernel"]=QString(firKernelName());
+		root["cases"]=report;
+		root["failed"]=failed;
+		std::fputs(QJsonDocument(root).toJson().constData(),stdout);
+		return failed>0 ? 2 : 0;
+	} catch(Error e) {
+		std::fprintf(stderr,"hamfax-regress: %s\n",
+			     e.getText().toLocal8Bit().constData());
+		return 1;
+	}
+}